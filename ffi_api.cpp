@@ -160,3 +160,24 @@ FfiResult load_program(const char* source, StringArray** out_program_array) {
         return create_ffi_result(-2, "Failed to load program: An unknown error occurred.");
     }
 }
+
+FfiResult edit_program(size_t offset, size_t removed_length, const char* inserted_text, StringArray** out_program_array) {
+    *out_program_array = nullptr;
+
+    if (inserted_text == nullptr) {
+        return create_ffi_result(-1, "Error: Inserted text cannot be null.");
+    }
+
+    try {
+        std::vector<std::string> vec = WorkShop::getInstance().editProgram(offset, removed_length, inserted_text);
+        *out_program_array = convert_vector_to_string_array(vec);
+
+        return create_ffi_result(0, "Program edited successfully.");
+    } catch (const std::exception& e) {
+        std::cerr << "[C++ FFI] Error editing program: " << e.what() << std::endl;
+        return create_ffi_result(-1, "Failed to edit program: " + std::string(e.what()));
+    } catch (...) {
+        std::cerr << "[C++ FFI] Unknown error during program editing." << std::endl;
+        return create_ffi_result(-2, "Failed to edit program: An unknown error occurred.");
+    }
+}
@@ -47,6 +47,8 @@ EXPORT_API bool get_vm_zero_flag();
 EXPORT_API bool get_vm_sign_flag();
 
 EXPORT_API FfiResult load_program(const char* source, StringArray** out_program_array);
+// 对上次加载的源码做一次编辑 (从 offset 起删除 removed_length 字节, 插入 inserted_text), 只重新词法分析编辑附近
+EXPORT_API FfiResult edit_program(size_t offset, size_t removed_length, const char* inserted_text, StringArray** out_program_array);
 
 
 #ifdef __cplusplus
@@ -1,11 +1,86 @@
 #include "lexer.h"
 #include <stdexcept>
+#include <algorithm>
+#include <future>
+#include "threadPool.h"
+#include "staticRegEx.h"
+
+// longest match wins, on equal length the earlier pattern wins
+// keywords come first so they take priority over IDENTIFIER inside the DFA
+static constexpr std::string_view TOKEN_PATTERNS[] = {
+    "if",
+    "else",
+    "while",
+    "int",
+    "return",
+
+    "\\d+",
+    "\\w+",
+
+    "(>)",
+    "(<)",
+    "(>=)",
+    "(<=)",
+    "(=)",
+    "(!=)",
+
+    "(\\+)",
+    "(\\-)",
+    "(\\*)",
+    "(/)",
+
+    "(\\()",
+    "(\\))",
+    "({)",
+    "(})",
+    "(;)",
+    "(,)",
+};
+
+// TOKEN_TYPES[i] is the type of TOKEN_PATTERNS[i]
+static constexpr _TokenType_ TOKEN_TYPES[] = {
+    _TokenType_::IF,
+    _TokenType_::ELSE,
+    _TokenType_::WHILE,
+    _TokenType_::INT,
+    _TokenType_::RETURN,
+
+    _TokenType_::INTEGER,
+    _TokenType_::IDENTIFIER,
+
+    _TokenType_::GREATER,
+    _TokenType_::LESS,
+    _TokenType_::GREATER_EQUAL,
+    _TokenType_::LESS_EQUAL,
+    _TokenType_::EQUAL,
+    _TokenType_::NOT_EQUAL,
+
+    _TokenType_::PLUS,
+    _TokenType_::MINUS,
+    _TokenType_::MULTIPLY,
+    _TokenType_::DIVIDE,
+
+    _TokenType_::L_PAREN,
+    _TokenType_::R_PAREN,
+    _TokenType_::L_BRACE,
+    _TokenType_::R_BRACE,
+    _TokenType_::SEMICOLON,
+    _TokenType_::COMMA,
+};
+
+static constexpr size_t TOKEN_PATTERN_COUNT = sizeof(TOKEN_PATTERNS) / sizeof(TOKEN_PATTERNS[0]);
+static_assert(TOKEN_PATTERN_COUNT == sizeof(TOKEN_TYPES) / sizeof(TOKEN_TYPES[0]), "every token pattern needs a type");
+
+static constexpr std::string_view WHITE_PATTERNS[] = {"\\s+"};
+
+static constexpr auto TOKEN_DFA = StaticRegExCompiler<64, 64, 32>::compile(TOKEN_PATTERNS);
+static constexpr auto WHITE_DFA = StaticRegExCompiler<4, 4, 4>::compile(WHITE_PATTERNS);
 
 Lexer::Lexer()
 {
     initRE();
 
-    input_ = "";
+    input_ = std::string_view();
     currentPos_ = 0;
 }
 
@@ -13,136 +88,365 @@ Lexer::Lexer(const std::string &input)
 {
     initRE();
 
-    input_ = input;
-    currentPos_ = 0;
+    setInput(input);
 }
 
 void Lexer::setInput(const std::string &input)
 {
-    input_ = input;
+    TokenBuffer::checkSourceSize(input.size());
+
+    mappedInput_.reset();
+    ownedInput_ = input;
+
+    input_ = ownedInput_;
     currentPos_ = 0;
+    lineIndex_.clear();
+}
+
+void Lexer::openFile(const std::string &path)
+{
+    std::unique_ptr<MappedFile> mappedInput = std::make_unique<MappedFile>(path);
+    TokenBuffer::checkSourceSize(mappedInput->size());
+
+    ownedInput_.clear();
+    ownedInput_.shrink_to_fit();
+    mappedInput_ = std::move(mappedInput);
+
+    input_ = mappedInput_->view();
+    currentPos_ = 0;
+    lineIndex_.clear();
+}
+
+SourceLocation Lexer::getLocation(size_t offset)
+{
+    return getLineIndex().locate(offset);
+}
+
+const LineIndex &Lexer::getLineIndex()
+{
+    if(!lineIndex_.isBuilt())
+    {
+        lineIndex_.build(input_);
+    }
+
+    return lineIndex_;
 }
 
 std::shared_ptr<Token> Lexer::getNextToken()
 {
-    std::optional<size_t> matchedNum = 0;
+    size_t start = 0;
+    size_t length = 0;
+    _TokenType_ type = scanToken(start, length);
+
+    return std::make_shared<Token>(type, std::string(input_.substr(start, length)));
+}
 
-    while (currentPos_ < input_.size())
+void Lexer::tokenize(TokenBuffer &tokens)
+{
+    tokens.clear();
+    tokens.setSource(input_);
+    currentPos_ = 0;
+
+    while(true)
+    {
+        size_t start = 0;
+        size_t length = 0;
+        _TokenType_ type = scanToken(start, length);
+
+        tokens.push(type, start, length);
+
+        if(type == _TokenType_::EOF_TOKEN)
+        {
+            break;
+        }
+    }
+}
+
+void Lexer::relex(TokenBuffer &tokens, size_t editOffset, size_t removedLength, std::string_view insertedText)
+{
+    if(editOffset > input_.size() || removedLength > input_.size() - editOffset)
+    {
+        throw std::out_of_range("edit out of range");
+    }
+    TokenBuffer::checkSourceSize(input_.size() - removedLength + insertedText.size());
+
+    if(mappedInput_)
+    {
+        ownedInput_.assign(input_.data(), input_.size());
+        mappedInput_.reset();
+    }
+    ownedInput_.replace(editOffset, removedLength, insertedText.data(), insertedText.size());
+
+    input_ = ownedInput_;
+    lineIndex_.clear();
+    tokens.setSource(input_);
+
+    const int64_t shift = static_cast<int64_t>(insertedText.size()) - static_cast<int64_t>(removedLength);
+    const size_t editEnd = editOffset + insertedText.size();
+
+    // keep the tokens ending strictly before the edit: the byte a token was terminated by is untouched,
+    // and longest match never looks further than that for these patterns.
+    // token ends only grow, so binary search for the first one reaching the edit
+    size_t keep = 0;
+    size_t high = tokens.size();
+    while(keep < high)
+    {
+        size_t mid = keep + (high - keep) / 2;
+        if(tokens.getOffset(mid) + tokens.getLength(mid) < editOffset)
+        {
+            keep = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    relexTokens_.clear();
+    relexTokens_.setSource(input_);
+    currentPos_ = (keep == 0) ? 0 : tokens.getOffset(keep - 1) + tokens.getLength(keep - 1);
+
+    size_t oldIndex = keep;
+    while(true)
+    {
+        size_t start = 0;
+        size_t length = 0;
+        _TokenType_ type = scanToken(start, length);
+
+        // past the edit the text is the old one, so a token starting where an old token started
+        // begins the same tail of tokens (the old EOF_TOKEN always lines up at the end)
+        if(start >= editEnd)
+        {
+            size_t oldStart = static_cast<size_t>(static_cast<int64_t>(start) - shift);
+            while(oldIndex < tokens.size() && tokens.getOffset(oldIndex) < oldStart)
+            {
+                oldIndex++;
+            }
+
+            if(oldIndex < tokens.size() && tokens.getOffset(oldIndex) == oldStart)
+            {
+                tokens.splice(keep, oldIndex, relexTokens_, shift);
+                break;
+            }
+        }
+
+        relexTokens_.push(type, start, length);
+
+        if(type == _TokenType_::EOF_TOKEN)
+        {
+            tokens.splice(keep, tokens.size(), relexTokens_, 0);
+            break;
+        }
+    }
+
+    currentPos_ = input_.size();
+}
+
+void Lexer::tokenizeParallel(TokenBuffer &tokens, size_t chunkCount)
+{
+    ThreadPool &pool = ThreadPool::getInstance();
+    if(chunkCount == 0)
+    {
+        chunkCount = pool.getThreadCount();
+    }
+    chunkCount = std::min(chunkCount, input_.size() / MIN_PARALLEL_CHUNK_SIZE);
+
+    // on a worker the chunks could wait behind the task that waits for them
+    if(chunkCount <= 1 || pool.isWorkerThread())
+    {
+        tokenize(tokens);
+        return;
+    }
+
+    // a token never contains whitespace, so a whitespace byte is a boundary the sequential
+    // lexer also passes through: lexing from there gives exactly the sequential tokens
+    std::vector<size_t> boundaries;
+    boundaries.push_back(0);
+    for(size_t i = 1; i < chunkCount; i++)
+    {
+        size_t pos = std::max(input_.size() / chunkCount * i, boundaries.back() + 1);
+        while(pos < input_.size() && !regExWhite_->match(input_.substr(pos, 1)).has_value())
+        {
+            pos++;
+        }
+
+        if(pos >= input_.size())
+        {
+            break;
+        }
+        boundaries.push_back(pos);
+    }
+    boundaries.push_back(input_.size());
+
+    const size_t chunks = boundaries.size() - 1;
+    if(chunkTokens_.size() < chunks)
+    {
+        chunkTokens_.resize(chunks);
+    }
+
+    // each chunk keeps the tokens starting before the next boundary and reports where it failed, if it did
+    std::vector<std::future<size_t>> results;
+    results.reserve(chunks);
+    for(size_t i = 0; i < chunks; i++)
+    {
+        results.push_back(pool.submit([this, i, &boundaries]()
+        {
+            TokenBuffer &chunk = chunkTokens_[i];
+            chunk.clear();
+            chunk.setSource(input_);
+
+            const bool isLast = (i + 1 == boundaries.size() - 1);
+            size_t pos = boundaries[i];
+            while(true)
+            {
+                size_t start = 0;
+                size_t length = 0;
+                _TokenType_ type = scanTokenAt(pos, start, length);
+
+                if(!isLast && start >= boundaries[i + 1])
+                {
+                    return NO_ERROR_OFFSET;
+                }
+                if(type == _TokenType_::UNKNOWN)
+                {
+                    return start;
+                }
+
+                chunk.push(type, start, length);
+
+                if(type == _TokenType_::EOF_TOKEN)
+                {
+                    return NO_ERROR_OFFSET;
+                }
+            }
+        }));
+    }
+
+    // wait for every chunk before leaving, the tasks use this lexer and boundaries
+    size_t errorOffset = NO_ERROR_OFFSET;
+    std::exception_ptr failure;
+    for(size_t i = 0; i < chunks; i++)
+    {
+        try
+        {
+            size_t chunkError = results[i].get();
+            if(errorOffset == NO_ERROR_OFFSET)
+            {
+                errorOffset = chunkError;
+            }
+        }
+        catch(...)
+        {
+            if(!failure)
+            {
+                failure = std::current_exception();
+            }
+        }
+    }
+
+    if(failure)
+    {
+        std::rethrow_exception(failure);
+    }
+
+    // the first failing chunk is where the sequential lexer would have stopped
+    if(errorOffset != NO_ERROR_OFFSET)
+    {
+        throwUnknownToken(errorOffset);
+    }
+
+    size_t tokenCount = 0;
+    for(size_t i = 0; i < chunks; i++)
+    {
+        tokenCount += chunkTokens_[i].size();
+    }
+
+    tokens.clear();
+    tokens.setSource(input_);
+    tokens.reserve(tokenCount);
+    for(size_t i = 0; i < chunks; i++)
+    {
+        tokens.append(chunkTokens_[i]);
+    }
+
+    currentPos_ = input_.size();
+}
+
+_TokenType_ Lexer::scanToken(size_t &start, size_t &length)
+{
+    _TokenType_ type = scanTokenAt(currentPos_, start, length);
+    if(type == _TokenType_::UNKNOWN)
+    {
+        throwUnknownToken(start);
+    }
+
+    return type;
+}
+
+_TokenType_ Lexer::scanTokenAt(size_t &pos, size_t &start, size_t &length) const
+{
+    while (pos < input_.size())
     {
         bool skippedSomething = true;
         while (skippedSomething)
         {
             skippedSomething = false;
 
-            std::optional<size_t> whitespaceLen = regExWhite_->match(input_.substr(currentPos_));
+            std::optional<size_t> whitespaceLen = regExWhite_->match(input_.substr(pos));
             if (whitespaceLen.has_value())
             {
-                currentPos_ += whitespaceLen.value();
+                pos += whitespaceLen.value();
                 skippedSomething = true;
                 continue;
             }
         }
 
-        if(currentPos_ >= input_.size())
+        if(pos >= input_.size())
         {
-            return std::make_shared<Token>(_TokenType_::EOF_TOKEN, "");
+            break;
         }
 
-        std::pair<std::optional<size_t>, std::shared_ptr<Token>> longestResult;
-
-        matchRE(regExNumber_, _TokenType_::INTEGER, longestResult);
-        matchRE(regExIdentifier_, _TokenType_::IDENTIFIER, longestResult);
-        matchRE(regExGreater_, _TokenType_::GREATER, longestResult);
-        matchRE(regExLess_, _TokenType_::LESS, longestResult);
-        matchRE(regExGreaterEqual_, _TokenType_::GREATER_EQUAL, longestResult);
-        matchRE(regExLessEqual_, _TokenType_::LESS_EQUAL, longestResult);
-        matchRE(regExEqual_, _TokenType_::EQUAL, longestResult);
-        matchRE(regExNotEqual_, _TokenType_::NOT_EQUAL, longestResult);
-        matchRE(regExPlus_, _TokenType_::PLUS, longestResult);
-        matchRE(regExMinus_, _TokenType_::MINUS, longestResult);
-        matchRE(regExMultiply_, _TokenType_::MULTIPLY, longestResult);
-        matchRE(regExDivide_, _TokenType_::DIVIDE, longestResult);
-        matchRE(regExEqual_, _TokenType_::EQUAL, longestResult);
-        matchRE(regExNotEqual_, _TokenType_::NOT_EQUAL, longestResult);
-        matchRE(regExLParen_, _TokenType_::L_PAREN, longestResult);
-        matchRE(regExRParen_, _TokenType_::R_PAREN, longestResult);
-        matchRE(regExLBrace_, _TokenType_::L_BRACE, longestResult);
-        matchRE(regExRBrace_, _TokenType_::R_BRACE, longestResult);
-        matchRE(regExSemicolon_, _TokenType_::SEMICOLON, longestResult);
-        matchRE(regExComma_, _TokenType_::COMMA, longestResult);
-
-        if(longestResult.first.has_value())
+        // match in place, the rest of the input is never copied
+        std::optional<RegExSetMatch> longestResult = regExTokens_->match(input_.substr(pos));
+
+        if(longestResult.has_value())
         {
-            currentPos_ += longestResult.first.value();
+            start = pos;
+            length = longestResult->length;
+            pos += length;
 
-            if(keywords_.find(longestResult.second->lexeme) != keywords_.end())
-            {
-                longestResult.second->type = keywords_[longestResult.second->lexeme];
-            }
-            
-            return longestResult.second;
+            return tokenTypes_[longestResult->patternId];
         }
         else
         {
-            throw std::runtime_error("Unknown token");
+            start = pos;
+            length = 0;
+            return _TokenType_::UNKNOWN;
         }
     }
 
-    return std::make_shared<Token>(_TokenType_::EOF_TOKEN, "");
+    start = input_.size();
+    length = 0;
+    return _TokenType_::EOF_TOKEN;
 }
 
-void Lexer::initRE()
+void Lexer::throwUnknownToken(size_t offset)
 {
-    keywords_["if"] = _TokenType_::IF;
-    keywords_["else"] = _TokenType_::ELSE;
-    keywords_["while"] = _TokenType_::WHILE;
-    keywords_["int"] = _TokenType_::INT;
-    keywords_["return"] = _TokenType_::RETURN;
-
+    SourceLocation location = getLocation(offset);
+    throw std::runtime_error("Unknown token at " + std::to_string(location.line) + ":" + std::to_string(location.column));
+}
 
+void Lexer::initRE()
+{
     // regExWhite_ = std::make_unique<RegEx>("( |\t|\n|\r)+");
     // regExNumber_ = std::make_unique<RegEx>("(0|1|2|3|4|5|6|7|8|9)+");
     // regExIdentifier_ = std::make_unique<RegEx>("(a|b|c|d|e|f|g|h|i|j|k|l|m|n|o|p|q|r|s|t|u|v|w|x|y|z|A|B|C|D|E|F|G|H|I|J|K|L|M|N|O|P|Q|R|S|T|U|V|W|X|Y|Z|0|1|2|3|4|5|6|7|8|9|_)+");
 
-    regExWhite_ = std::make_unique<RegEx>("\\s+");
-    regExNumber_ = std::make_unique<RegEx>("\\d+");
-    regExIdentifier_ = std::make_unique<RegEx>("\\w+");
-
-    regExGreater_ = std::make_unique<RegEx>("(>)");
-    regExLess_ = std::make_unique<RegEx>("(<)");
-    regExGreaterEqual_ = std::make_unique<RegEx>("(>=)");
-    regExLessEqual_ = std::make_unique<RegEx>("(<=)");
-    regExEqual_ = std::make_unique<RegEx>("(=)");
-    regExNotEqual_ = std::make_unique<RegEx>("(!=)");
-
-    regExPlus_ = std::make_unique<RegEx>("(\\+)");
-    regExMinus_ = std::make_unique<RegEx>("(\\-)");
-    regExMultiply_ = std::make_unique<RegEx>("(\\*)");
-    regExDivide_ = std::make_unique<RegEx>("(/)");
-
-    regExEqual_ = std::make_unique<RegEx>("(=)");
-    regExNotEqual_ = std::make_unique<RegEx>("(!=)");
-
-    regExLParen_ = std::make_unique<RegEx>("(\\()");
-    regExRParen_ = std::make_unique<RegEx>("(\\))");
-    regExLBrace_ = std::make_unique<RegEx>("({)");
-    regExRBrace_ = std::make_unique<RegEx>("(})");
-    regExSemicolon_ = std::make_unique<RegEx>("(;)");
-    regExComma_ = std::make_unique<RegEx>("(,)");
-}
+    // tables were built at compile time and are shared by every lexer in the process
+    static const std::shared_ptr<const RegEx> sharedWhite = std::make_shared<const RegEx>(WHITE_DFA.toDFATable());
+    static const std::shared_ptr<const RegExSet> sharedTokens = std::make_shared<const RegExSet>(TOKEN_DFA.toDFATable(), TOKEN_PATTERN_COUNT);
 
-void Lexer::matchRE(const std::unique_ptr<RegEx> &regEx,
-                    _TokenType_ tokenType,
-                    std::pair<std::optional<size_t>, std::shared_ptr<Token>> &result)
-{
-    std::optional<size_t> matchedNum = regEx->match(input_.substr(currentPos_));
-    if (matchedNum.has_value())
-    {
-        if (!result.first.has_value() || matchedNum.value() > result.first.value())
-        {
-            std::string matchedStr = input_.substr(currentPos_, matchedNum.value());
-            // currentPos_ += matchedNum.value();
-            result = std::make_pair(matchedNum, std::make_shared<Token>(tokenType, matchedStr));
-        }
-    }
+    regExWhite_ = sharedWhite;
+    regExTokens_ = sharedTokens;
+    tokenTypes_.assign(std::begin(TOKEN_TYPES), std::end(TOKEN_TYPES));
 }
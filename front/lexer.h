@@ -3,9 +3,13 @@
 
 #include <string>
 #include <memory>
-#include <map>
+#include <vector>
 #include "token.h"
+#include "tokenBuffer.h"
+#include "lineIndex.h"
+#include "mappedFile.h"
 #include "regEx.h"
+#include "regExSet.h"
 
 
 class Lexer
@@ -15,46 +19,67 @@ public:
     Lexer(const std::string &input);
     ~Lexer() = default;
 
+    // input_ may view ownedInput_, so the lexer stays where it was built
+    Lexer(const Lexer&) = delete;
+    Lexer& operator=(const Lexer&) = delete;
+
+    // inputs over TokenBuffer::MAX_SOURCE_SIZE bytes are rejected with runtime_error
     void setInput(const std::string &input);
+    // maps the file read-only and lexes straight from the mapping
+    void openFile(const std::string &path);
     std::shared_ptr<Token> getNextToken();
 
+    // lexes the whole input into tokens (EOF_TOKEN included), lexemes view this lexer's input
+    void tokenize(TokenBuffer &tokens);
+
+    // same tokens as tokenize(), lexed in chunks on the shared ThreadPool.
+    // 0 chunks means one per worker, inputs too small to split are lexed sequentially,
+    // and so is everything when called from a ThreadPool task
+    void tokenizeParallel(TokenBuffer &tokens, size_t chunkCount = 0);
+
+    // applies an edit to the input and patches tokens, which must hold the tokenize() result of the old input
+    // (an empty buffer is also accepted and simply gets the whole input lexed).
+    // re-lexes from the last token ending before the edit until the stream lines up with the old one again.
+    // if it throws, the input is already edited and tokens must be rebuilt with tokenize()
+    void relex(TokenBuffer &tokens, size_t editOffset, size_t removedLength, std::string_view insertedText);
+
+    // line index is built on the first call, the scan loop never counts lines
+    SourceLocation getLocation(size_t offset);
+    // the same index, for resolving many token positions at once
+    const LineIndex &getLineIndex();
+
 private:
     void initRE();
-    void matchRE(const std::unique_ptr<RegEx> &regEx,
-                 _TokenType_ tokenType,
-                 std::pair<std::optional<size_t>, std::shared_ptr<Token>> &result);
+    _TokenType_ scanToken(size_t &start, size_t &length);
+    // returns UNKNOWN instead of throwing and only touches pos, so chunks can share the lexer
+    _TokenType_ scanTokenAt(size_t &pos, size_t &start, size_t &length) const;
+    void throwUnknownToken(size_t offset);
 
 private:
-    std::string input_;
-    size_t currentPos_;
+    static constexpr size_t MIN_PARALLEL_CHUNK_SIZE = 256 * 1024;
+    static constexpr size_t NO_ERROR_OFFSET = static_cast<size_t>(-1);
 
 private:
-    std::unique_ptr<RegEx> regExWhite_;
-    std::unique_ptr<RegEx> regExNumber_;
-    std::unique_ptr<RegEx> regExIdentifier_;
-
-    std::unique_ptr<RegEx> regExGreater_;
-    std::unique_ptr<RegEx> regExLess_;
-    std::unique_ptr<RegEx> regExGreaterEqual_;
-    std::unique_ptr<RegEx> regExLessEqual_;
-
-    std::unique_ptr<RegEx> regExPlus_;
-    std::unique_ptr<RegEx> regExMinus_;
-    std::unique_ptr<RegEx> regExMultiply_;
-    std::unique_ptr<RegEx> regExDivide_;
-    
-    std::unique_ptr<RegEx> regExEqual_;
-    std::unique_ptr<RegEx> regExNotEqual_;
-
-    std::unique_ptr<RegEx> regExLParen_;
-    std::unique_ptr<RegEx> regExRParen_;
-    std::unique_ptr<RegEx> regExLBrace_;
-    std::unique_ptr<RegEx> regExRBrace_;
-    std::unique_ptr<RegEx> regExSemicolon_;
-    std::unique_ptr<RegEx> regExComma_;
+    std::string_view input_;
+    size_t currentPos_;
+
+    // backing storage of input_, at most one of them is in use
+    std::string ownedInput_;
+    std::unique_ptr<MappedFile> mappedInput_;
+
+    // tokens re-lexed by relex(), kept to reuse the capacity
+    TokenBuffer relexTokens_;
+    // per chunk output of tokenizeParallel(), kept to reuse the capacity
+    std::vector<TokenBuffer> chunkTokens_;
+    LineIndex lineIndex_;
 
 private:
-    std::map<std::string, _TokenType_> keywords_;
+    // eager DFAs only: match() is then read-only and safe from several threads
+    std::shared_ptr<const RegEx> regExWhite_;
+
+    // every token pattern in one DFA, the pattern id indexes tokenTypes_
+    std::shared_ptr<const RegExSet> regExTokens_;
+    std::vector<_TokenType_> tokenTypes_;
 };
 
 #endif // _LEXER_H_
\ No newline at end of file
@@ -0,0 +1,90 @@
+#include "lineIndex.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LINE_INDEX_SSE2
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#ifdef LINE_INDEX_SSE2
+static inline unsigned lowestBit(unsigned mask)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+#endif
+
+void LineIndex::build(std::string_view source)
+{
+    lineStarts_.clear();
+    lineStarts_.push_back(0);
+
+    const char *data = source.data();
+    const size_t size = source.size();
+    size_t pos = 0;
+
+#ifdef LINE_INDEX_SSE2
+    // 16 bytes per step, one bit per '\n' in the compare mask
+    const __m128i newline = _mm_set1_epi8('\n');
+    for(; pos + 16 <= size; pos += 16)
+    {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + pos));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, newline)));
+        while(mask != 0)
+        {
+            lineStarts_.push_back(static_cast<uint32_t>(pos + lowestBit(mask) + 1));
+            mask &= mask - 1;
+        }
+    }
+#endif
+
+    while(pos < size)
+    {
+        const void *found = std::memchr(data + pos, '\n', size - pos);
+        if(found == nullptr)
+        {
+            break;
+        }
+
+        pos = static_cast<size_t>(static_cast<const char *>(found) - data) + 1;
+        lineStarts_.push_back(static_cast<uint32_t>(pos));
+    }
+}
+
+void LineIndex::clear()
+{
+    lineStarts_.clear();
+}
+
+bool LineIndex::isBuilt() const
+{
+    return !lineStarts_.empty();
+}
+
+size_t LineIndex::getLineCount() const
+{
+    return lineStarts_.size();
+}
+
+SourceLocation LineIndex::locate(size_t offset) const
+{
+    if(lineStarts_.empty())
+    {
+        return SourceLocation{0, 0};
+    }
+
+    // last line start that is <= offset
+    auto it = std::upper_bound(lineStarts_.begin(), lineStarts_.end(), offset);
+    size_t line = static_cast<size_t>(it - lineStarts_.begin()) - 1;
+
+    return SourceLocation{static_cast<int>(line + 1), static_cast<int>(offset - lineStarts_[line] + 1)};
+}
@@ -0,0 +1,34 @@
+#ifndef _LINE_INDEX_H_
+#define _LINE_INDEX_H_
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// 1-based, column counted in bytes
+struct SourceLocation
+{
+    int line;
+    int column;
+};
+
+// Byte offsets of every line start, built once per source.
+// Tokens only keep offsets; locate() resolves them by binary search when asked.
+class LineIndex
+{
+public:
+    LineIndex() = default;
+    ~LineIndex() = default;
+
+    void build(std::string_view source);
+    void clear();
+
+    bool isBuilt() const;
+    size_t getLineCount() const;
+    SourceLocation locate(size_t offset) const;
+
+private:
+    std::vector<uint32_t> lineStarts_;
+};
+
+#endif // _LINE_INDEX_H_
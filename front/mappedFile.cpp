@@ -0,0 +1,154 @@
+#include "mappedFile.h"
+#include <stdexcept>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string &path)
+{
+    data_ = nullptr;
+    size_ = 0;
+    fileHandle_ = INVALID_HANDLE_VALUE;
+    mappingHandle_ = nullptr;
+
+    fileHandle_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if(fileHandle_ == INVALID_HANDLE_VALUE)
+    {
+        throw std::runtime_error("cannot open file: " + path);
+    }
+
+    LARGE_INTEGER fileSize;
+    if(!GetFileSizeEx(fileHandle_, &fileSize))
+    {
+        unmap();
+        throw std::runtime_error("cannot stat file: " + path);
+    }
+
+    size_ = static_cast<size_t>(fileSize.QuadPart);
+    if(size_ == 0)
+    {
+        return;
+    }
+
+    mappingHandle_ = CreateFileMappingA(fileHandle_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if(mappingHandle_ == nullptr)
+    {
+        unmap();
+        throw std::runtime_error("cannot map file: " + path);
+    }
+
+    data_ = static_cast<const char *>(MapViewOfFile(mappingHandle_, FILE_MAP_READ, 0, 0, 0));
+    if(data_ == nullptr)
+    {
+        unmap();
+        throw std::runtime_error("cannot map file: " + path);
+    }
+}
+
+void MappedFile::unmap()
+{
+    if(data_ != nullptr)
+    {
+        UnmapViewOfFile(data_);
+    }
+    if(mappingHandle_ != nullptr)
+    {
+        CloseHandle(mappingHandle_);
+    }
+    if(fileHandle_ != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(fileHandle_);
+    }
+
+    data_ = nullptr;
+    size_ = 0;
+    mappingHandle_ = nullptr;
+    fileHandle_ = INVALID_HANDLE_VALUE;
+}
+
+#else
+
+MappedFile::MappedFile(const std::string &path)
+{
+    data_ = nullptr;
+    size_ = 0;
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0)
+    {
+        throw std::runtime_error("cannot open file: " + path);
+    }
+
+    struct stat fileStat;
+    if(fstat(fd, &fileStat) != 0)
+    {
+        close(fd);
+        throw std::runtime_error("cannot stat file: " + path);
+    }
+
+    size_t size = static_cast<size_t>(fileStat.st_size);
+    if(size == 0)
+    {
+        close(fd);
+        return;
+    }
+
+    void *mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping stays valid after the descriptor is closed
+    close(fd);
+
+    if(mapping == MAP_FAILED)
+    {
+        throw std::runtime_error("cannot map file: " + path);
+    }
+
+    // the lexer reads front to back
+    madvise(mapping, size, MADV_SEQUENTIAL);
+
+    data_ = static_cast<const char *>(mapping);
+    size_ = size;
+}
+
+void MappedFile::unmap()
+{
+    if(data_ != nullptr)
+    {
+        munmap(const_cast<char *>(data_), size_);
+    }
+
+    data_ = nullptr;
+    size_ = 0;
+}
+
+#endif
+
+MappedFile::~MappedFile()
+{
+    unmap();
+}
+
+const char *MappedFile::data() const
+{
+    return data_;
+}
+
+size_t MappedFile::size() const
+{
+    return size_;
+}
+
+std::string_view MappedFile::view() const
+{
+    return std::string_view(data_ == nullptr ? "" : data_, size_);
+}
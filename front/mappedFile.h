@@ -0,0 +1,35 @@
+#ifndef _MAPPED_FILE_H_
+#define _MAPPED_FILE_H_
+
+#include <string>
+#include <string_view>
+
+// Read-only memory mapping of a whole file, unmapped on destruction.
+// An empty file maps to an empty view.
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::string &path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char *data() const;
+    size_t size() const;
+    std::string_view view() const;
+
+private:
+    void unmap();
+
+private:
+    const char *data_;
+    size_t size_;
+
+#ifdef _WIN32
+    void *fileHandle_;
+    void *mappingHandle_;
+#endif
+};
+
+#endif // _MAPPED_FILE_H_
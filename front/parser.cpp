@@ -2,6 +2,8 @@
 #include "predefineSymbol.h"
 #include <stdexcept>
 #include <stack>
+#include <algorithm>
+#include <string>
 #include <stackItem.h>
 #include <iostream>
 
@@ -49,7 +51,8 @@ bool Parser::parse(const std::vector<Token> &tokens)
         }
         if (actionTable_.at(stateId).find(*current_lookahead_symbol) == actionTable_.at(stateId).end())
         {
-            throw std::runtime_error("no action in table");
+            // past the end the lookahead stays on the last token
+            throwUnexpectedToken(tokens.at(std::min(inputIndex, tokens.size() - 1)));
         }
         else
         {
@@ -106,6 +109,19 @@ bool Parser::parse(const std::vector<Token> &tokens)
     throw std::runtime_error("parse error");
 }
 
+void Parser::throwUnexpectedToken(const Token &token) const
+{
+    std::string message = "unexpected token " + tokenTypeToString(token.type) + " '" + token.lexeme + "'";
+
+    // line 0 means the caller did not resolve positions
+    if (token.line > 0)
+    {
+        message += " at " + std::to_string(token.line) + ":" + std::to_string(token.column);
+    }
+
+    throw std::runtime_error(message);
+}
+
 const IRProgram &Parser::getIRProgram() const
 {
     return program_;
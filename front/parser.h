@@ -18,6 +18,8 @@ public:
 
 private:
     GrammarSymbol map(const Token &token) const;
+    // reports the position when the token carries one
+    void throwUnexpectedToken(const Token &token) const;
 
 private:
     const Grammar &grammar_;
@@ -0,0 +1,112 @@
+#include "tokenBuffer.h"
+#include <stdexcept>
+#include <string>
+
+void TokenBuffer::checkSourceSize(size_t size)
+{
+    if(size > MAX_SOURCE_SIZE)
+    {
+        throw std::runtime_error("source too large: " + std::to_string(size) + " bytes, at most " + std::to_string(MAX_SOURCE_SIZE) + " are supported");
+    }
+}
+
+void TokenBuffer::clear()
+{
+    types_.clear();
+    offsets_.clear();
+    lengths_.clear();
+}
+
+void TokenBuffer::reserve(size_t count)
+{
+    types_.reserve(count);
+    offsets_.reserve(count);
+    lengths_.reserve(count);
+}
+
+void TokenBuffer::setSource(std::string_view source)
+{
+    checkSourceSize(source.size());
+    source_ = source;
+}
+
+std::string_view TokenBuffer::getSource() const
+{
+    return source_;
+}
+
+void TokenBuffer::push(_TokenType_ type, size_t offset, size_t length)
+{
+    types_.push_back(static_cast<uint8_t>(type));
+    offsets_.push_back(static_cast<uint32_t>(offset));
+    lengths_.push_back(static_cast<uint32_t>(length));
+}
+
+void TokenBuffer::append(const TokenBuffer &other)
+{
+    types_.insert(types_.end(), other.types_.begin(), other.types_.end());
+    offsets_.insert(offsets_.end(), other.offsets_.begin(), other.offsets_.end());
+    lengths_.insert(lengths_.end(), other.lengths_.begin(), other.lengths_.end());
+}
+
+void TokenBuffer::splice(size_t first, size_t last, const TokenBuffer &replacement, int64_t shift)
+{
+    for(size_t i = last; i < offsets_.size(); i++)
+    {
+        offsets_[i] = static_cast<uint32_t>(static_cast<int64_t>(offsets_[i]) + shift);
+    }
+
+    types_.erase(types_.begin() + first, types_.begin() + last);
+    offsets_.erase(offsets_.begin() + first, offsets_.begin() + last);
+    lengths_.erase(lengths_.begin() + first, lengths_.begin() + last);
+
+    types_.insert(types_.begin() + first, replacement.types_.begin(), replacement.types_.end());
+    offsets_.insert(offsets_.begin() + first, replacement.offsets_.begin(), replacement.offsets_.end());
+    lengths_.insert(lengths_.begin() + first, replacement.lengths_.begin(), replacement.lengths_.end());
+}
+
+size_t TokenBuffer::size() const
+{
+    return types_.size();
+}
+
+bool TokenBuffer::empty() const
+{
+    return types_.empty();
+}
+
+_TokenType_ TokenBuffer::getType(size_t index) const
+{
+    return static_cast<_TokenType_>(types_[index]);
+}
+
+uint32_t TokenBuffer::getOffset(size_t index) const
+{
+    return offsets_[index];
+}
+
+uint32_t TokenBuffer::getLength(size_t index) const
+{
+    return lengths_[index];
+}
+
+std::string_view TokenBuffer::getLexeme(size_t index) const
+{
+    return source_.substr(offsets_[index], lengths_[index]);
+}
+
+Token TokenBuffer::getToken(size_t index) const
+{
+    return Token(getType(index), std::string(getLexeme(index)));
+}
+
+Token TokenBuffer::getToken(size_t index, const LineIndex &lines) const
+{
+    Token token = getToken(index);
+
+    SourceLocation location = lines.locate(offsets_[index]);
+    token.line = location.line;
+    token.column = location.column;
+
+    return token;
+}
@@ -0,0 +1,58 @@
+#ifndef _TOKEN_BUFFER_H_
+#define _TOKEN_BUFFER_H_
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "token.h"
+#include "lineIndex.h"
+
+// Struct-of-arrays token storage: type, source offset and length per token.
+// Lexemes are views into the source, which must outlive the buffer contents.
+// clear() keeps the capacity, so one buffer can be refilled without reallocating.
+// Offsets and lengths are 32 bit, so sources are limited to MAX_SOURCE_SIZE bytes.
+class TokenBuffer
+{
+public:
+    static constexpr size_t MAX_SOURCE_SIZE = UINT32_MAX;
+
+    // throws runtime_error for a source the 32 bit offsets cannot address
+    static void checkSourceSize(size_t size);
+
+    TokenBuffer() = default;
+    ~TokenBuffer() = default;
+
+    void clear();
+    void reserve(size_t count);
+
+    void setSource(std::string_view source);
+    std::string_view getSource() const;
+
+    void push(_TokenType_ type, size_t offset, size_t length);
+    // appends tokens of a buffer over the same source
+    void append(const TokenBuffer &other);
+    // replaces tokens [first, last) with all of replacement, tokens after them move by shift bytes
+    void splice(size_t first, size_t last, const TokenBuffer &replacement, int64_t shift);
+
+    size_t size() const;
+    bool empty() const;
+
+    _TokenType_ getType(size_t index) const;
+    uint32_t getOffset(size_t index) const;
+    uint32_t getLength(size_t index) const;
+    std::string_view getLexeme(size_t index) const;
+
+    // materializes an owning Token, for consumers that still need one
+    Token getToken(size_t index) const;
+    // same, with line and column resolved through the index
+    Token getToken(size_t index, const LineIndex &lines) const;
+
+private:
+    std::string_view source_;
+
+    std::vector<uint8_t> types_;
+    std::vector<uint32_t> offsets_;
+    std::vector<uint32_t> lengths_;
+};
+
+#endif // _TOKEN_BUFFER_H_
@@ -0,0 +1,295 @@
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "regExSet.h"
+
+// cpl_lexgen <spec> <output header> [namespace]
+//
+// spec, one token per line, '#' starts a comment line:
+//     NAME PRIORITY REGEX
+// the regex is the rest of the line. Longest match wins, on equal length the lower priority
+// value wins (then the earlier line). Tokens named SKIP are consumed without being returned
+// and may repeat, every other name is given once. END_OF_INPUT and ERROR are reserved.
+//
+// The output is a self-contained header: static byte class, transition and accept tables
+// plus an inline scan loop, nothing of this repo is needed to compile it.
+
+struct TokenSpec
+{
+    std::string name;
+    int priority;
+    std::string pattern;
+    size_t line;
+};
+
+static const std::string SKIP_NAME = "SKIP";
+// the generated scanner adds these kinds itself
+static const std::string RESERVED_NAMES[] = {"END_OF_INPUT", "ERROR"};
+
+static bool isIdentifier(const std::string &name)
+{
+    if(name.empty() || std::isdigit(static_cast<unsigned char>(name[0])))
+    {
+        return false;
+    }
+
+    return std::all_of(name.begin(), name.end(), [](char c) { return std::isalnum(static_cast<unsigned char>(c)) || c == '_'; });
+}
+
+static std::vector<TokenSpec> readSpec(const std::string &path)
+{
+    std::ifstream input(path);
+    if(!input)
+    {
+        throw std::runtime_error("cannot open spec: " + path);
+    }
+
+    std::vector<TokenSpec> specs;
+    std::string text;
+    size_t lineNumber = 0;
+    while(std::getline(input, text))
+    {
+        lineNumber++;
+        if(!text.empty() && text.back() == '\r')
+        {
+            text.pop_back();
+        }
+
+        size_t first = text.find_first_not_of(" \t");
+        if(first == std::string::npos || text[first] == '#')
+        {
+            continue;
+        }
+
+        std::istringstream fields(text);
+        TokenSpec spec;
+        spec.line = lineNumber;
+        if(!(fields >> spec.name >> spec.priority))
+        {
+            throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": expected NAME PRIORITY REGEX");
+        }
+
+        std::getline(fields, spec.pattern);
+        size_t begin = spec.pattern.find_first_not_of(" \t");
+        size_t end = spec.pattern.find_last_not_of(" \t");
+        spec.pattern = (begin == std::string::npos) ? "" : spec.pattern.substr(begin, end - begin + 1);
+
+        if(!isIdentifier(spec.name))
+        {
+            throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": token name must be an identifier");
+        }
+        if(std::find(std::begin(RESERVED_NAMES), std::end(RESERVED_NAMES), spec.name) != std::end(RESERVED_NAMES))
+        {
+            throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": token name " + spec.name + " is reserved");
+        }
+        if(spec.name != SKIP_NAME)
+        {
+            auto previous = std::find_if(specs.begin(), specs.end(), [&spec](const TokenSpec &other) { return other.name == spec.name; });
+            if(previous != specs.end())
+            {
+                throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": token " + spec.name + " already defined on line " + std::to_string(previous->line));
+            }
+        }
+        if(spec.pattern.empty())
+        {
+            throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": missing regex");
+        }
+
+        specs.push_back(spec);
+    }
+
+    if(specs.empty())
+    {
+        throw std::runtime_error("no tokens in spec: " + path);
+    }
+
+    std::stable_sort(specs.begin(), specs.end(), [](const TokenSpec &a, const TokenSpec &b) { return a.priority < b.priority; });
+
+    return specs;
+}
+
+template <typename T>
+static void emitArray(std::ostream &out, const std::string &type, const std::string &name, const std::vector<T> &values, size_t perLine)
+{
+    out << "inline constexpr " << type << " " << name << "[" << values.size() << "] = {";
+    for(size_t i = 0; i < values.size(); i++)
+    {
+        out << ((i % perLine == 0) ? "\n    " : " ") << static_cast<long long>(values[i]) << ",";
+    }
+    out << "\n};\n\n";
+}
+
+static void emitScanner(std::ostream &out, const std::vector<TokenSpec> &specs, const DFATable &table, const std::string &nameSpace, const std::string &specPath)
+{
+    // SKIP is no token kind, names are unique otherwise so every other pattern is its own kind
+    std::vector<std::string> kinds;
+    std::vector<int> patternKinds;
+    std::vector<int> patternSkips;
+    for(const auto &spec : specs)
+    {
+        bool skip = (spec.name == SKIP_NAME);
+        if(!skip)
+        {
+            kinds.push_back(spec.name);
+        }
+
+        patternKinds.push_back(skip ? -1 : static_cast<int>(kinds.size()) - 1);
+        patternSkips.push_back(skip ? 1 : 0);
+    }
+
+    const size_t stateCount = table.getStateCount();
+    const size_t classCount = table.getClassCount();
+    const std::string stateType = (stateCount < 0x7fff) ? "int16_t" : "int32_t";
+
+    std::vector<int> byteClasses(table.getByteClassMap().begin(), table.getByteClassMap().end());
+
+    std::vector<int32_t> transitions;
+    std::vector<int32_t> accepts;
+    for(size_t state = 0; state < stateCount; state++)
+    {
+        accepts.push_back(table.getAcceptTag(static_cast<int32_t>(state)));
+        for(size_t byteClass = 0; byteClass < classCount; byteClass++)
+        {
+            transitions.push_back(table.getTransition(static_cast<int32_t>(state), static_cast<uint8_t>(byteClass)));
+        }
+    }
+
+    std::string guard = "_" + nameSpace + "_H_";
+    std::transform(guard.begin(), guard.end(), guard.begin(), [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+
+    out << "// generated by cpl_lexgen from " << specPath << ", do not edit\n";
+    out << "#ifndef " << guard << "\n#define " << guard << "\n\n";
+    out << "#include <cstddef>\n#include <cstdint>\n\n";
+    out << "namespace " << nameSpace << "\n{\n\n";
+
+    out << "enum class TokenKind\n{\n";
+    for(const auto &kind : kinds)
+    {
+        out << "    " << kind << ",\n";
+    }
+    out << "    END_OF_INPUT,\n    ERROR,\n};\n\n";
+
+    out << "// KIND_NAME[kind] is the spec name of the kind\n";
+    out << "inline constexpr const char *KIND_NAME[" << kinds.size() + 2 << "] = {";
+    for(const auto &kind : kinds)
+    {
+        out << "\n    \"" << kind << "\",";
+    }
+    out << "\n    \"END_OF_INPUT\",\n    \"ERROR\",\n};\n\n";
+
+    out << "struct Token\n{\n    TokenKind kind;\n    size_t offset;\n    size_t length;\n};\n\n";
+
+    out << "inline constexpr size_t STATE_COUNT = " << stateCount << ";\n";
+    out << "inline constexpr size_t CLASS_COUNT = " << classCount << ";\n\n";
+
+    emitArray(out, "uint8_t", "BYTE_CLASS", byteClasses, 16);
+    emitArray(out, stateType, "TRANSITIONS", transitions, classCount < 2 ? 16 : classCount);
+    emitArray(out, "int16_t", "ACCEPT_PATTERN", accepts, 16);
+    emitArray(out, "int16_t", "PATTERN_KIND", patternKinds, 16);
+    emitArray(out, "uint8_t", "PATTERN_SKIP", patternSkips, 16);
+
+    out << "// longest match at pos, SKIP matches are stepped over. pos moves past the returned token;\n";
+    out << "// ERROR leaves it on the offending byte, END_OF_INPUT on size.\n";
+    out << "inline Token next(const char *data, size_t size, size_t &pos)\n";
+    out << "{\n";
+    out << "    while(true)\n";
+    out << "    {\n";
+    out << "        if(pos >= size)\n";
+    out << "        {\n";
+    out << "            return Token{TokenKind::END_OF_INPUT, size, 0};\n";
+    out << "        }\n\n";
+    out << "        int32_t state = 0;\n";
+    out << "        int32_t pattern = -1;\n";
+    out << "        size_t length = 0;\n";
+    out << "        for(size_t i = pos; i < size; i++)\n";
+    out << "        {\n";
+    out << "            state = TRANSITIONS[static_cast<size_t>(state) * CLASS_COUNT + BYTE_CLASS[static_cast<unsigned char>(data[i])]];\n";
+    out << "            if(state < 0)\n";
+    out << "            {\n";
+    out << "                break;\n";
+    out << "            }\n";
+    out << "            if(ACCEPT_PATTERN[state] >= 0)\n";
+    out << "            {\n";
+    out << "                pattern = ACCEPT_PATTERN[state];\n";
+    out << "                length = i + 1 - pos;\n";
+    out << "            }\n";
+    out << "        }\n\n";
+    out << "        if(pattern < 0)\n";
+    out << "        {\n";
+    out << "            return Token{TokenKind::ERROR, pos, 0};\n";
+    out << "        }\n\n";
+    out << "        size_t start = pos;\n";
+    out << "        pos += length;\n";
+    out << "        if(!PATTERN_SKIP[pattern])\n";
+    out << "        {\n";
+    out << "            return Token{static_cast<TokenKind>(PATTERN_KIND[pattern]), start, length};\n";
+    out << "        }\n";
+    out << "    }\n";
+    out << "}\n\n";
+
+    out << "} // namespace " << nameSpace << "\n\n";
+    out << "#endif // " << guard << "\n";
+}
+
+int main(int argc, char *argv[])
+{
+    if(argc < 3)
+    {
+        std::cerr << "usage: cpl_lexgen <spec> <output header> [namespace]" << std::endl;
+        return 1;
+    }
+
+    const std::string specPath = argv[1];
+    const std::string outputPath = argv[2];
+    const std::string nameSpace = (argc > 3) ? argv[3] : "cpl_scanner";
+
+    try
+    {
+        // the namespace also names the include guard
+        if(!isIdentifier(nameSpace))
+        {
+            throw std::runtime_error("namespace must be an identifier: " + nameSpace);
+        }
+
+        std::vector<TokenSpec> specs = readSpec(specPath);
+
+        std::vector<std::string> patterns;
+        for(const auto &spec : specs)
+        {
+            patterns.push_back(spec.pattern);
+        }
+
+        RegExSet regExSet(patterns);
+        const DFATable &table = regExSet.getDFATable();
+
+        // an empty match would never move the scanner forward
+        if(table.isEndState(table.getStartState()))
+        {
+            throw std::runtime_error("pattern of " + specs[table.getAcceptTag(table.getStartState())].name + " matches the empty string");
+        }
+
+        std::ofstream output(outputPath, std::ios::binary);
+        if(!output)
+        {
+            throw std::runtime_error("cannot write output: " + outputPath);
+        }
+
+        emitScanner(output, specs, table, nameSpace, specPath);
+
+        std::cout << "cpl_lexgen: " << specs.size() << " tokens, " << table.getStateCount() << " states, "
+                  << table.getClassCount() << " byte classes -> " << outputPath << std::endl;
+    }
+    catch(const std::exception &e)
+    {
+        std::cerr << "cpl_lexgen: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -16,11 +16,26 @@
 #include "workShop.h"
 
 
-int main()
+int main(int argc, char *argv[])
 {
+    // cpl <source file>, without one the built-in sample is compiled
+    if(argc > 1)
+    {
+        try
+        {
+            WorkShop::getInstance().loadProgramFile(argv[1]);
+        }
+        catch(const std::exception &e)
+        {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+    }
+    else
+    {
+        WorkShop::getInstance().loadProgram("1+3*5");
+    }
 
-
-    WorkShop::getInstance().loadProgram("1+3*5");
     std::vector<std::string> src = WorkShop::getInstance().getVMSrc();
 
     return 0;
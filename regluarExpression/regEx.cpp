@@ -1,142 +1,703 @@
 #include "regEx.h"
 #include "alphaBet.h"
-#include <queue>
 #include "regExParser.h"
+#include "regExSimplifier.h"
+#include "regExCharNode.h"
+#include "regExCharSetNode.h"
+#include "regExConcatenationNode.h"
+#include "regExKleeneStarNode.h"
+#include "regExPlusNode.h"
+#include <cstring>
+#include "threadPool.h"
 
-RegEx::RegEx(const std::string &regex)
+RegEx::RegEx(const std::string &regex, const RegExOptions &options)
 {
+    options_ = options;
+
     RegExParser regExParser(regex);
-    root_ = regExParser.getRoot();
+    buildDFA(RegExSimplifier::simplify(regExParser.getRoot()));
+}
 
-    nfaStateFragment_ = root_->buildNfaStateFragment();
-    buildDFA();
+RegEx::RegEx(std::shared_ptr<RegExNode> root, const RegExOptions &options)
+{
+    options_ = options;
+    buildDFA(RegExSimplifier::simplify(root));
 }
 
-RegEx::RegEx(std::shared_ptr<RegExNode> root)
+RegEx::RegEx(DFATable dfaTable)
 {
-    root_ = root;
+    dfaTable_ = std::move(dfaTable);
 
-    nfaStateFragment_ = root_->buildNfaStateFragment();
-    buildDFA();
+    stats_.dfaStateCount = dfaTable_.getStateCount();
+    stats_.minimizedDfaStateCount = dfaTable_.getStateCount();
+    stats_.byteClassCount = dfaTable_.getClassCount();
+
+    selectDFAEngine();
 }
 
 RegEx::~RegEx()
 {
 }
 
-std::optional<size_t> RegEx::match(const std::string &str)
+std::optional<size_t> RegEx::match(std::string_view str) const
 {
-    std::shared_ptr<DFAState> currentDFAState = startDFAState_;
-    size_t index = 0;
+    if(specializedEngine_ == RegExEngine::LITERAL)
+    {
+        if(str.size() >= literal_.size() && std::memcmp(str.data(), literal_.data(), literal_.size()) == 0)
+        {
+            return literal_.size();
+        }
+
+        return std::nullopt;
+    }
+
+    if(specializedEngine_ == RegExEngine::CHARSET_RUN)
+    {
+        size_t length = 0;
+        while(length < str.size() && runBytes_[static_cast<unsigned char>(str[length])])
+        {
+            length++;
+        }
+
+        if(length < runMinLength_)
+        {
+            return std::nullopt;
+        }
+
+        return length;
+    }
+
+    if(shengDfa_)
+    {
+        return shengDfa_->match(str.data(), str.size());
+    }
+
+    if(lazyDfa_)
+    {
+        return lazyDfa_->match(str.data(), str.size());
+    }
+
+    if(pikeVm_)
+    {
+        return pikeVm_->match(str.data(), str.size());
+    }
+
+    int32_t currentState = dfaTable_.getStartState();
     std::optional<size_t> matchedIndex = std::nullopt;
 
-    if(currentDFAState->isEndState())
+    if(dfaTable_.isEndState(currentState))
     {
         matchedIndex = 0;
     }
-    
-    for(char character : str)
+
+    const char *data = str.data();
+    const size_t size = str.size();
+
+    for(size_t index = 0; index < size; index++)
     {
-        currentDFAState = currentDFAState->run(character);
+        int32_t nextState = dfaTable_.run(currentState, data[index]);
+        if(nextState == currentState && accelerator_.isAccelerable(currentState))
+        {
+            // the state stays put for the whole run, only where it ends matters
+            index = accelerator_.skip(currentState, data, index + 1, size) - 1;
+        }
+        currentState = nextState;
 
-        if(!currentDFAState)
+        if(currentState == DFATable::DEAD_STATE)
         {
-            return matchedIndex;
+            break;
         }
 
-        index++;
-        if(currentDFAState->isEndState())
+        if(dfaTable_.isEndState(currentState))
         {
-            matchedIndex = index;
+            matchedIndex = index + 1;
         }
     }
 
     return matchedIndex;
 }
 
-void RegEx::buildDFA()
+std::optional<RegExMatch> RegEx::search(std::string_view str, size_t from) const
+{
+    if(from > str.size())
+    {
+        return std::nullopt;
+    }
+
+    if(lazyDfa_ || pikeVm_)
+    {
+        std::vector<bool> starts = findMatchStarts(str, from);
+        return searchMarked(str, from, starts);
+    }
+
+    DeadEnds deadEnds;
+    return searchFrom(str, from, deadEnds);
+}
+
+std::vector<RegExMatch> RegEx::findAll(std::string_view str) const
 {
-    std::set<std::shared_ptr<NFAState>, CompareNfaStateSharedPtr> startStates = epsilonClosure({nfaStateFragment_->getStartState()});
+    std::vector<RegExMatch> matches;
+
+    // the marks and the dead ends hold for the whole buffer, so every search shares them
+    std::vector<bool> starts;
+    DeadEnds deadEnds;
+    if(lazyDfa_ || pikeVm_)
+    {
+        starts = findMatchStarts(str, 0);
+    }
 
-    std::queue<std::set<std::shared_ptr<NFAState>, CompareNfaStateSharedPtr>> queue;
-    queue.push(startStates);
+    size_t from = 0;
+    while(from <= str.size())
+    {
+        std::optional<RegExMatch> found = (lazyDfa_ || pikeVm_) ? searchMarked(str, from, starts) : searchFrom(str, from, deadEnds);
+        if(!found)
+        {
+            break;
+        }
 
-    dfaStateMap_[startStates] = std::make_shared<DFAState>(isContainEndState(startStates));
-    startDFAState_ = dfaStateMap_[startStates];
+        matches.push_back(*found);
+        from = found->offset + ((found->length > 0) ? found->length : 1);
+    }
 
-    while(!queue.empty())
+    return matches;
+}
+
+std::optional<RegExMatch> RegEx::searchFrom(std::string_view str, size_t from, DeadEnds &deadEnds) const
+{
+    if(specializedEngine_ == RegExEngine::LITERAL)
     {
-        auto currentStates = queue.front();
-        queue.pop();
+        size_t offset = str.find(literal_, from);
+        if(offset == std::string_view::npos)
+        {
+            return std::nullopt;
+        }
 
-        std::shared_ptr<DFAState> currentDfaState = dfaStateMap_[currentStates];
+        return RegExMatch{offset, literal_.size()};
+    }
 
-        for(const auto &charactar : AlphaBet::instance().getcharactars())
+    if(specializedEngine_ == RegExEngine::CHARSET_RUN)
+    {
+        // x* matches right away, x+ at the first byte of a run
+        size_t offset = from;
+        while(runMinLength_ > 0 && offset < str.size() && !runBytes_[static_cast<unsigned char>(str[offset])])
         {
-            std::set<std::shared_ptr<NFAState>, CompareNfaStateSharedPtr> nextAllStates;
-            for(const auto &state : currentStates)
-            {
-                std::set<std::shared_ptr<NFAState>, CompareNfaStateSharedPtr> nextStates = state->run(charactar);
-                nextAllStates.insert(nextStates.begin(), nextStates.end());
-            }
+            offset++;
+        }
+        if(offset == str.size() && runMinLength_ > 0)
+        {
+            return std::nullopt;
+        }
 
-            nextAllStates = epsilonClosure(nextAllStates);
+        return RegExMatch{offset, *match(str.substr(offset))};
+    }
 
-            if(nextAllStates.empty())
-            {
-                continue;
-            }
+    for(size_t start = from; start <= str.size(); start++)
+    {
+        std::optional<size_t> end = matchAt(str, start, deadEnds);
+        if(end)
+        {
+            return RegExMatch{start, *end - start};
+        }
+    }
+
+    return std::nullopt;
+}
+
+std::optional<RegExMatch> RegEx::searchMarked(std::string_view str, size_t from, const std::vector<bool> &starts) const
+{
+    for(size_t start = from; start <= str.size(); start++)
+    {
+        if(!starts[start])
+        {
+            continue;
+        }
+
+        std::optional<size_t> length = match(str.substr(start));
+        if(length)
+        {
+            return RegExMatch{start, *length};
+        }
+    }
+
+    return std::nullopt;
+}
+
+std::optional<size_t> RegEx::matchAt(std::string_view str, size_t start, DeadEnds &deadEnds) const
+{
+    const StateAccelerator &accelerator = shengDfa_ ? shengDfa_->getAccelerator() : accelerator_;
+    const char *data = str.data();
+    const size_t size = str.size();
+
+    int32_t currentState = dfaTable_.getStartState();
+    std::optional<size_t> matchedEnd = std::nullopt;
+    if(dfaTable_.isEndState(currentState))
+    {
+        matchedEnd = start;
+    }
+
+    // where the scan last accepted (or started), everything it passes after that is a dead end
+    int32_t lastAcceptState = currentState;
+    size_t lastAcceptEnd = start;
+
+    size_t end = start;
+    while(end < size)
+    {
+        int32_t nextState = dfaTable_.run(currentState, data[end]);
+        if(nextState == DFATable::DEAD_STATE)
+        {
+            break;
+        }
+
+        if(nextState == currentState && accelerator.isAccelerable(currentState))
+        {
+            end = accelerator.skip(currentState, data, end + 1, size);
+        }
+        else
+        {
+            end++;
+        }
+        currentState = nextState;
+
+        if(dfaTable_.isEndState(currentState))
+        {
+            matchedEnd = end;
+            lastAcceptState = currentState;
+            lastAcceptEnd = end;
+        }
+        else if(deadEnds.contains(end, currentState))
+        {
+            break;
+        }
+    }
+
+    // short tails are cheap to rescan, recording them would cost more than it saves
+    if(end - lastAcceptEnd >= MIN_DEAD_END_RUN)
+    {
+        currentState = lastAcceptState;
+        for(size_t offset = lastAcceptEnd; offset < end; offset++)
+        {
+            currentState = dfaTable_.run(currentState, data[offset]);
+            deadEnds.insert(offset + 1, currentState, size, dfaTable_.getStateCount());
+        }
+    }
+
+    return matchedEnd;
+}
+
+void RegEx::DeadEnds::insert(size_t offset, int32_t state, size_t size, size_t stateCount)
+{
+    if(firstState.empty())
+    {
+        firstState.assign(size + 1, DFATable::DEAD_STATE);
+        this->stateCount = stateCount;
+    }
+
+    if(firstState[offset] == DFATable::DEAD_STATE)
+    {
+        firstState[offset] = state;
+    }
+    else if(firstState[offset] != state)
+    {
+        otherStates.insert(offset * stateCount + static_cast<size_t>(state));
+    }
+}
+
+bool RegEx::DeadEnds::contains(size_t offset, int32_t state) const
+{
+    if(firstState.empty())
+    {
+        return false;
+    }
+
+    if(firstState[offset] == state)
+    {
+        return true;
+    }
+
+    return !otherStates.empty() && otherStates.count(offset * stateCount + static_cast<size_t>(state)) != 0;
+}
+
+std::vector<std::optional<size_t>> RegEx::matchMany(const std::vector<std::string_view> &inputs) const
+{
+    std::vector<std::optional<size_t>> results(inputs.size());
+
+    auto matchRange = [this, &inputs, &results](size_t first, size_t last)
+    {
+        for(size_t i = first; i < last; i++)
+        {
+            results[i] = match(inputs[i]);
+        }
+    };
+
+    ThreadPool &pool = ThreadPool::getInstance();
+    size_t batchCount = std::min(pool.getThreadCount(), inputs.size() / MIN_PARALLEL_BATCH_SIZE);
+    // on a worker the batches could wait behind the task that waits for them
+    if(lazyDfa_ || batchCount <= 1 || pool.isWorkerThread())
+    {
+        matchRange(0, inputs.size());
+        return results;
+    }
+
+    // every task writes its own slice of results, nothing is shared but the read-only tables
+    std::vector<std::future<void>> batches;
+    batches.reserve(batchCount);
+    for(size_t i = 0; i < batchCount; i++)
+    {
+        size_t first = inputs.size() / batchCount * i;
+        size_t last = (i + 1 == batchCount) ? inputs.size() : inputs.size() / batchCount * (i + 1);
+        batches.push_back(pool.submit([&matchRange, first, last]() { matchRange(first, last); }));
+    }
 
-            if(dfaStateMap_.find(nextAllStates) == dfaStateMap_.end())
+    // the tasks reference results, so wait for all of them before leaving
+    std::exception_ptr failure;
+    for(auto &batch : batches)
+    {
+        try
+        {
+            batch.get();
+        }
+        catch(...)
+        {
+            if(!failure)
             {
-                queue.push(nextAllStates);
-                dfaStateMap_[nextAllStates] = std::make_shared<DFAState>(isContainEndState(nextAllStates));
+                failure = std::current_exception();
             }
+        }
+    }
+
+    if(failure)
+    {
+        std::rethrow_exception(failure);
+    }
 
-            currentDfaState->addTransition(charactar, dfaStateMap_[nextAllStates]);
+    return results;
+}
+
+const DFATable *RegEx::getReverseDFA() const
+{
+    std::call_once(reverseDfaFlag_, [this]()
+    {
+        if(!root_)
+        {
+            return;
         }
+
+        // scanning backwards, whatever follows the match is skipped by the leading .*,
+        // so every accepting step marks an offset where a match starts
+        auto anyChar = std::make_shared<RegExCharSetNode>(std::set<char>(), true);
+        auto reversed = std::make_shared<RegExConcatenationNode>(std::make_shared<RegExKleeneStarNode>(anyChar), root_->reverse());
+
+        RegExStats reverseStats;
+        reverseDfaTable_ = buildMinimizedDFA(*reversed, reverseStats);
+    });
+
+    return reverseDfaTable_ ? &*reverseDfaTable_ : nullptr;
+}
+
+std::vector<bool> RegEx::findMatchStarts(std::string_view str, size_t from) const
+{
+    const DFATable *reverseDfa = getReverseDFA();
+    if(!reverseDfa)
+    {
+        // no reverse DFA, leave it to the anchored match at every offset
+        std::vector<bool> starts(str.size() + 1, true);
+        return starts;
+    }
+
+    std::vector<bool> starts(str.size() + 1, false);
+
+    const int32_t startState = reverseDfa->getStartState();
+    int32_t currentState = startState;
+    starts[str.size()] = reverseDfa->isEndState(currentState);
+
+    for(size_t index = str.size(); index > from; index--)
+    {
+        currentState = reverseDfa->run(currentState, str[index - 1]);
+
+        // a byte outside the alphabet ends every match, start over behind it
+        if(currentState == DFATable::DEAD_STATE)
+        {
+            currentState = startState;
+        }
+
+        starts[index - 1] = reverseDfa->isEndState(currentState);
+    }
+
+    return starts;
+}
+
+RegExStats RegEx::getStats() const
+{
+    if(specializedEngine_)
+    {
+        getSpecializedDFA();
+        return specializedStats_;
+    }
+
+    RegExStats stats = stats_;
+
+    if(lazyDfa_)
+    {
+        stats.dfaStateCount = lazyDfa_->getStateCount();
+        stats.lazyCacheMemory = lazyDfa_->getCacheMemory();
+        stats.lazyCacheFlushCount = lazyDfa_->getFlushCount();
     }
+
+    return stats;
 }
 
- 
-std::set<std::shared_ptr<NFAState>, CompareNfaStateSharedPtr> RegEx::epsilonClosure(const std::set<std::shared_ptr<NFAState>, CompareNfaStateSharedPtr> &states)
+RegExEngine RegEx::getEngine() const
 {
-    std::set<std::shared_ptr<NFAState>, CompareNfaStateSharedPtr> result = states;
-    std::queue<std::shared_ptr<NFAState>> queue;
-  
-    for(const auto &state : states)
+    if(specializedEngine_)
+    {
+        return *specializedEngine_;
+    }
+
+    if(shengDfa_)
     {
-        queue.push(state);
+        return RegExEngine::SHENG;
     }
 
-    while (!queue.empty())
+    if(lazyDfa_)
     {
-        auto state = queue.front();
-        queue.pop();
+        return RegExEngine::LAZY_DFA;
+    }
 
-        for (auto &epsilonState : state->getEpsilonTransitions())
+    if(pikeVm_)
+    {
+        return RegExEngine::PIKE_VM;
+    }
+
+    return RegExEngine::DFA;
+}
+
+void RegEx::save(const std::string &path) const
+{
+    if(specializedEngine_)
+    {
+        const DFATable *dfaTable = getSpecializedDFA();
+        if(!dfaTable)
         {
-            if (auto lockedState = epsilonState.lock())
+            throw std::logic_error("the DFA of this RegEx is over budget and cannot be saved");
+        }
+
+        dfaTable->save(path);
+        return;
+    }
+
+    if(getEngine() != RegExEngine::DFA && getEngine() != RegExEngine::SHENG)
+    {
+        throw std::logic_error("only a RegEx on a DFA engine can be saved");
+    }
+
+    dfaTable_.save(path);
+}
+
+void RegEx::buildDFA(const std::shared_ptr<RegExNode> &root)
+{
+    if(options_.mode == RegExMode::PIKE_VM)
+    {
+        buildPikeVM(*root);
+        root_ = root;
+        return;
+    }
+
+    if(options_.mode == RegExMode::EAGER_DFA && options_.specializeSimplePatterns && buildSpecialized(*root))
+    {
+        return;
+    }
+
+    if(options_.mode == RegExMode::LAZY_DFA)
+    {
+        ByteClassSet byteClassSet;
+        NFA nfa;
+        NfaStateFragment fragment = buildNFA(*root, nfa, byteClassSet);
+
+        lazyDfa_ = std::make_unique<LazyDFA>(nfa, fragment.getStartState(), byteClassSet, options_.lazyCacheBudget);
+        stats_.byteClassCount = byteClassSet.getClassCount();
+        root_ = root;
+        return;
+    }
+
+    std::optional<DFATable> dfaTable = buildMinimizedDFA(*root, stats_);
+    if(!dfaTable)
+    {
+        // over budget, match by simulating the NFA instead
+        buildPikeVM(*root);
+        root_ = root;
+        return;
+    }
+
+    // the DFA engines search with the table alone, the tree is dropped here
+    dfaTable_ = std::move(*dfaTable);
+    selectDFAEngine();
+}
+
+NfaStateFragment RegEx::buildNFA(const RegExNode &root, NFA &nfa, ByteClassSet &byteClassSet)
+{
+    // bytes outside the alphabet never transition, so the alphabet is a class boundary as well
+    byteClassSet.addCharSet(AlphaBet::instance().getcharactars());
+    root.collectByteClasses(byteClassSet);
+
+    NfaStateFragment fragment = root.buildNfaStateFragment(nfa);
+    nfa.getState(fragment.getEndState()).setAcceptTag(0);
+
+    return fragment;
+}
+
+std::optional<DFATable> RegEx::buildMinimizedDFA(const RegExNode &root, RegExStats &stats) const
+{
+    // the NFA arena only lives until the subset construction has copied what it needs
+    ByteClassSet byteClassSet;
+    NFA nfa;
+    NfaStateFragment fragment = buildNFA(root, nfa, byteClassSet);
+
+    LazyDFA subsetBuilder(nfa, fragment.getStartState(), byteClassSet, options_.maxDfaMemory);
+    std::optional<DFATable> dfaTable = subsetBuilder.toDFATable(options_.maxDfaStates);
+    if(!dfaTable)
+    {
+        return std::nullopt;
+    }
+
+    stats.dfaStateCount = dfaTable->getStateCount();
+    DFATable minimized = dfaTable->minimize();
+    stats.minimizedDfaStateCount = minimized.getStateCount();
+    stats.byteClassCount = minimized.getClassCount();
+
+    return minimized;
+}
+
+const DFATable *RegEx::getSpecializedDFA() const
+{
+    std::call_once(specializedDfaFlag_, [this]()
+    {
+        // literal_ and runBytes_ are all these engines keep of the pattern, rebuild its tree from them
+        std::shared_ptr<RegExNode> root;
+        if(specializedEngine_ == RegExEngine::LITERAL)
+        {
+            for(char character : literal_)
+            {
+                auto charNode = std::make_shared<RegExCharNode>(character);
+                root = root ? std::make_shared<RegExConcatenationNode>(root, charNode) : std::shared_ptr<RegExNode>(charNode);
+            }
+        }
+        else
+        {
+            std::set<char> charSet;
+            for(size_t byte = 0; byte < DFATable::BYTE_COUNT; byte++)
             {
-                if(result.insert(lockedState).second)
+                if(runBytes_[byte])
                 {
-                    queue.push(lockedState);
+                    charSet.insert(static_cast<char>(byte));
                 }
             }
+
+            auto charSetNode = std::make_shared<RegExCharSetNode>(charSet);
+            if(runMinLength_ > 0)
+            {
+                root = std::make_shared<RegExPlusNode>(charSetNode);
+            }
+            else
+            {
+                root = std::make_shared<RegExKleeneStarNode>(charSetNode);
+            }
         }
+
+        specializedStats_ = stats_;
+        specializedDfaTable_ = buildMinimizedDFA(*root, specializedStats_);
+    });
+
+    return specializedDfaTable_ ? &*specializedDfaTable_ : nullptr;
+}
+
+void RegEx::selectDFAEngine()
+{
+    // small enough to live in one vector register
+    shengDfa_ = ShengDFA::fromDFATable(dfaTable_);
+    if(shengDfa_)
+    {
+        stats_.acceleratedStateCount = shengDfa_->getAccelerator().getAcceleratedStateCount();
+        return;
     }
 
-    return result;
+    accelerator_ = StateAccelerator(dfaTable_);
+    stats_.acceleratedStateCount = accelerator_.getAcceleratedStateCount();
 }
 
-bool RegEx::isContainEndState(const std::set<std::shared_ptr<NFAState>, CompareNfaStateSharedPtr> &states)
+void RegEx::buildPikeVM(const RegExNode &root)
 {
-    for (const auto &state : states)
+    PikeProgram program;
+    root.compilePikeProgram(program);
+    program.emitMatch();
+
+    pikeVm_ = std::make_unique<PikeVM>(std::move(program));
+}
+
+bool RegEx::buildSpecialized(const RegExNode &root)
+{
+    if(appendLiteral(root))
+    {
+        specializedEngine_ = RegExEngine::LITERAL;
+        return true;
+    }
+    literal_.clear();
+
+    // a single char or char set under + or *
+    const RegExNode *item = nullptr;
+    if(auto plusNode = dynamic_cast<const RegExPlusNode *>(&root))
+    {
+        item = plusNode->getNode().get();
+        runMinLength_ = 1;
+    }
+    else if(auto kleeneStarNode = dynamic_cast<const RegExKleeneStarNode *>(&root))
+    {
+        item = kleeneStarNode->getNode().get();
+        runMinLength_ = 0;
+    }
+
+    if(auto charNode = dynamic_cast<const RegExCharNode *>(item))
+    {
+        runBytes_[static_cast<unsigned char>(charNode->getCharactar())] = true;
+    }
+    else if(auto charSetNode = dynamic_cast<const RegExCharSetNode *>(item))
     {
-        if (state == nfaStateFragment_->getEndState())
+        // same bytes the NFA gets: a negated set only covers the rest of the alphabet
+        const std::set<char> &charSet = charSetNode->getCharSet();
+        if(charSetNode->isNegated())
         {
-            return true;
+            for(char character : AlphaBet::instance().getcharactars())
+            {
+                runBytes_[static_cast<unsigned char>(character)] = (charSet.find(character) == charSet.end());
+            }
         }
+        else
+        {
+            for(char character : charSet)
+            {
+                runBytes_[static_cast<unsigned char>(character)] = true;
+            }
+        }
+    }
+    else
+    {
+        return false;
+    }
+
+    specializedEngine_ = RegExEngine::CHARSET_RUN;
+    return true;
+}
+
+bool RegEx::appendLiteral(const RegExNode &node)
+{
+    if(auto charNode = dynamic_cast<const RegExCharNode *>(&node))
+    {
+        literal_.push_back(charNode->getCharactar());
+        return true;
+    }
+
+    if(auto concatenationNode = dynamic_cast<const RegExConcatenationNode *>(&node))
+    {
+        return appendLiteral(*concatenationNode->getLeft()) && appendLiteral(*concatenationNode->getRight());
     }
 
     return false;
@@ -1,38 +1,182 @@
 #ifndef _REGEX_H_
 #define _REGEX_H_
 
+#include <array>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <map>
 #include <set>
 #include "regExNode.h"
-#include "dfaState.h"
-#include "nfaState.h"
+#include "dfaTable.h"
+#include "lazyDfa.h"
+#include "pikeVm.h"
+#include "shengDfa.h"
 #include <optional>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
 
+enum class RegExMode
+{
+    EAGER_DFA,
+    LAZY_DFA,
+    PIKE_VM,
+};
+
+// the engine a RegEx actually matches with
+enum class RegExEngine
+{
+    DFA,
+    // EAGER_DFA whose minimized table fits ShengDFA
+    SHENG,
+    // EAGER_DFA patterns simple enough to need no automaton: "abc" and [class]+ / [class]*
+    LITERAL,
+    CHARSET_RUN,
+    LAZY_DFA,
+    PIKE_VM,
+};
+
+struct RegExOptions
+{
+    RegExMode mode = RegExMode::EAGER_DFA;
+
+    // upper bound (in bytes) of the state cache in LAZY_DFA mode
+    size_t lazyCacheBudget = 1 << 20;
+
+    // EAGER_DFA falls back to the Pike VM when the DFA would exceed either budget,
+    // the NFA the DFA is built from counts against maxDfaMemory too
+    size_t maxDfaStates = 10000;
+    size_t maxDfaMemory = 16 << 20;
+
+    // EAGER_DFA matches plain literals and single char set runs without an automaton (LITERAL and
+    // CHARSET_RUN), off they get the DFA or SHENG engine like every other pattern
+    bool specializeSimplePatterns = true;
+};
+
+struct RegExMatch
+{
+    size_t offset = 0;
+    size_t length = 0;
+};
+
+struct RegExStats
+{
+    size_t dfaStateCount = 0;
+    size_t minimizedDfaStateCount = 0;
+    size_t byteClassCount = 0;
+    // states whose self-loop runs are skipped by StateAccelerator
+    size_t acceleratedStateCount = 0;
+
+    size_t lazyCacheMemory = 0;
+    size_t lazyCacheFlushCount = 0;
+};
+
+// Built once, then read-only: the DFA and PIKE_VM engines can be shared between threads
+// (RegExCache hands them out as shared_ptr<const RegEx>). Only LAZY_DFA writes while matching.
 class RegEx
 {
 public:
-    explicit RegEx(const std::string& regex);
-    explicit RegEx(std::shared_ptr<RegExNode> root);
+    // inputs per task in matchMany, fewer are matched on the calling thread
+    static constexpr size_t MIN_PARALLEL_BATCH_SIZE = 4096;
+
+    explicit RegEx(const std::string& regex, const RegExOptions& options = RegExOptions());
+    explicit RegEx(std::shared_ptr<RegExNode> root, const RegExOptions& options = RegExOptions());
+    // a prebuilt table (e.g. from StaticRegExCompiler), always the DFA engine
+    explicit RegEx(DFATable dfaTable);
     ~RegEx();
 
     //NOTICE: Longest Prefix Match
-    std::optional<size_t> match(const std::string& str);
+    //NOTICE: in LAZY_DFA mode match fills the state cache and must not be called concurrently
+    std::optional<size_t> match(std::string_view str) const;
+
+    // leftmost-longest match starting at or after from.
+    // DFA and SHENG try every start from `from` on, but a scan stops where an earlier one already
+    // found no further accept, so a call is O(k * states) worst case and about O(k) in practice,
+    // k being the bytes from `from` to where the found match's scan ends. LITERAL and CHARSET_RUN
+    // are O(k). LAZY_DFA and PIKE_VM scan the whole tail backwards first, O(n - from) per call.
+    std::optional<RegExMatch> search(std::string_view str, size_t from = 0) const;
+    // non-overlapping leftmost-longest matches, an empty match steps one byte on.
+    // O(n * states) worst case on the DFA engines, O(n) on LITERAL and CHARSET_RUN. LAZY_DFA and
+    // PIKE_VM mark the starts once, but every match may still scan to the end: O(n^2) worst case
+    std::vector<RegExMatch> findAll(std::string_view str) const;
+
+    // match() of every input, fanned out over the shared ThreadPool (LAZY_DFA stays on the calling thread).
+    // not meant to be nested in a ThreadPool task: on a pool worker it runs inline, since waiting
+    // there for batches queued behind the caller could deadlock the pool
+    std::vector<std::optional<size_t>> matchMany(const std::vector<std::string_view>& inputs) const;
+
+    RegExStats getStats() const;
+    RegExEngine getEngine() const;
+
+    // writes the DFA for RegEx(DFATable::load(path)). LITERAL and CHARSET_RUN build theirs on the
+    // first save() or getStats(), LAZY_DFA and PIKE_VM have none
+    void save(const std::string& path) const;
 
 private:
-    void buildDFA();
-    std::set<std::shared_ptr<NFAState>, CompareNfaStateSharedPtr> epsilonClosure(const std::set<std::shared_ptr<NFAState>, CompareNfaStateSharedPtr>& states);
-    bool isContainEndState(const std::set<std::shared_ptr<NFAState>, CompareNfaStateSharedPtr>& states);
+    void buildDFA(const std::shared_ptr<RegExNode>& root);
+    static NfaStateFragment buildNFA(const RegExNode& root, NFA& nfa, ByteClassSet& byteClassSet);
+    // null over the maxDfaStates / maxDfaMemory budget
+    std::optional<DFATable> buildMinimizedDFA(const RegExNode& root, RegExStats& stats) const;
+    const DFATable* getSpecializedDFA() const;
+    void buildPikeVM(const RegExNode& root);
+    void selectDFAEngine();
+    bool buildSpecialized(const RegExNode& root);
+    bool appendLiteral(const RegExNode& node);
+
+    // (end offset, state) pairs a scan passed after its last accept: from there nothing accepts any
+    // more, so a later scan reaching one stops. Each pair is recorded once, which bounds findAll
+    struct DeadEnds
+    {
+        // the first state recorded per offset, the rest go to the set
+        std::vector<int32_t> firstState;
+        std::unordered_set<size_t> otherStates;
+        size_t stateCount = 0;
+
+        void insert(size_t offset, int32_t state, size_t size, size_t stateCount);
+        bool contains(size_t offset, int32_t state) const;
+    };
+
+    // dead-end tails shorter than this are rescanned rather than recorded
+    static constexpr size_t MIN_DEAD_END_RUN = 32;
+
+    std::optional<RegExMatch> searchFrom(std::string_view str, size_t from, DeadEnds& deadEnds) const;
+    std::optional<RegExMatch> searchMarked(std::string_view str, size_t from, const std::vector<bool>& starts) const;
+    // end of the longest match of dfaTable_ at start
+    std::optional<size_t> matchAt(std::string_view str, size_t start, DeadEnds& deadEnds) const;
+
+    const DFATable* getReverseDFA() const;
+    std::vector<bool> findMatchStarts(std::string_view str, size_t from) const;
 
 private:
-    // std::string regex_;
+    RegExOptions options_;
+
+    DFATable dfaTable_;
+    std::unique_ptr<LazyDFA> lazyDfa_;
+    std::unique_ptr<PikeVM> pikeVm_;
+    std::unique_ptr<ShengDFA> shengDfa_;
+    StateAccelerator accelerator_;
+
+    // set when buildSpecialized took the pattern, no automaton is built then
+    std::optional<RegExEngine> specializedEngine_;
+    std::string literal_;
+    std::array<bool, DFATable::BYTE_COUNT> runBytes_ = {};
+    size_t runMinLength_ = 0;
+
+    // the DFA the specialized engines stand in for, built from literal_ or runBytes_
+    // when save() or getStats() needs it
+    mutable std::once_flag specializedDfaFlag_;
+    mutable std::optional<DFATable> specializedDfaTable_;
+    mutable RegExStats specializedStats_;
+
+    RegExStats stats_;
+
+    // kept only by LAZY_DFA and PIKE_VM, whose searches build the reverse DFA from it
     std::shared_ptr<RegExNode> root_;
-    std::shared_ptr<NfaStateFragment> nfaStateFragment_;
-    std::map<std::set<std::shared_ptr<NFAState>, CompareNfaStateSharedPtr>, std::shared_ptr<DFAState>> dfaStateMap_;
 
-    std::shared_ptr<DFAState> startDFAState_;
-    std::shared_ptr<DFAState> endDFAState_;
+    // .* followed by the reversed pattern, built on the first LAZY_DFA or PIKE_VM search
+    mutable std::once_flag reverseDfaFlag_;
+    mutable std::optional<DFATable> reverseDfaTable_;
 };
 
 #endif // _REGEX_H_
\ No newline at end of file
@@ -10,26 +10,49 @@ RegExAlternationNode::~RegExAlternationNode()
 {
 }
 
-std::shared_ptr<NfaStateFragment> RegExAlternationNode::buildNfaStateFragment()
+NfaStateFragment RegExAlternationNode::buildNfaStateFragment(NFA &nfa) const
 {
-    auto leftFragment = left_->buildNfaStateFragment();
-    auto rightFragment = right_->buildNfaStateFragment();
+    NfaStateFragment leftFragment = left_->buildNfaStateFragment(nfa);
+    NfaStateFragment rightFragment = right_->buildNfaStateFragment(nfa);
 
-    auto startState = std::make_shared<NFAState>();
-    auto endState = std::make_shared<NFAState>();
+    int32_t startState = nfa.addState();
+    int32_t endState = nfa.addState();
 
-    startState->addEpsilonTransition(leftFragment->getStartState());
-    startState->addEpsilonTransition(rightFragment->getStartState());
+    nfa.getState(startState).addEpsilonTransition(leftFragment.getStartState());
+    nfa.getState(startState).addEpsilonTransition(rightFragment.getStartState());
 
-    leftFragment->getEndState()->addEpsilonTransition(endState);
-    rightFragment->getEndState()->addEpsilonTransition(endState);
+    nfa.getState(leftFragment.getEndState()).addEpsilonTransition(endState);
+    nfa.getState(rightFragment.getEndState()).addEpsilonTransition(endState);
 
-    std::shared_ptr<NfaStateFragment> fragment = std::make_shared<NfaStateFragment>(startState, endState);
-    fragment->addState(startState);
-    fragment->addState(endState);
+    return NfaStateFragment(startState, endState);
+}
+
+void RegExAlternationNode::collectByteClasses(ByteClassSet &byteClassSet) const
+{
+    left_->collectByteClasses(byteClassSet);
+    right_->collectByteClasses(byteClassSet);
+}
+
+void RegExAlternationNode::compilePikeProgram(PikeProgram &program) const
+{
+    //     split L1, L2
+    // L1: left
+    //     jump L3
+    // L2: right
+    // L3:
+    int32_t split = program.emitSplit();
+
+    program.patchX(split, program.getNextPc());
+    left_->compilePikeProgram(program);
+    int32_t jump = program.emitJump();
 
-    fragment->merge(leftFragment);
-    fragment->merge(rightFragment);
+    program.patchY(split, program.getNextPc());
+    right_->compilePikeProgram(program);
 
-    return fragment;
+    program.patchX(jump, program.getNextPc());
+}
+
+std::shared_ptr<RegExNode> RegExAlternationNode::reverse() const
+{
+    return std::make_shared<RegExAlternationNode>(left_->reverse(), right_->reverse());
 }
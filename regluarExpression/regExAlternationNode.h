@@ -10,7 +10,10 @@ public:
     explicit RegExAlternationNode(std::shared_ptr<RegExNode> left, std::shared_ptr<RegExNode> right);
     virtual ~RegExAlternationNode();
 
-    std::shared_ptr<NfaStateFragment> buildNfaStateFragment() override;
+    NfaStateFragment buildNfaStateFragment(NFA &nfa) const override;
+    void collectByteClasses(ByteClassSet &byteClassSet) const override;
+    void compilePikeProgram(PikeProgram &program) const override;
+    std::shared_ptr<RegExNode> reverse() const override;
 
     std::shared_ptr<RegExNode> getLeft() const { return left_; };
     std::shared_ptr<RegExNode> getRight() const { return right_; };
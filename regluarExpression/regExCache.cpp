@@ -0,0 +1,150 @@
+#include "regExCache.h"
+
+// length-prefixed so that no two pattern lists share a key
+static void appendKeyPart(std::string &key, const std::string &part)
+{
+    key += std::to_string(part.size());
+    key += ':';
+    key += part;
+}
+
+static std::string makeRegExKey(const std::string &pattern, const RegExOptions &options)
+{
+    std::string key = "r";
+    appendKeyPart(key, std::to_string(static_cast<int>(options.mode)));
+    appendKeyPart(key, std::to_string(options.lazyCacheBudget));
+    appendKeyPart(key, std::to_string(options.maxDfaStates));
+    appendKeyPart(key, std::to_string(options.maxDfaMemory));
+    appendKeyPart(key, std::to_string(options.specializeSimplePatterns));
+    appendKeyPart(key, pattern);
+    return key;
+}
+
+static std::string makeRegExSetKey(const std::vector<std::string> &patterns)
+{
+    std::string key = "s";
+    for(const auto &pattern : patterns)
+    {
+        appendKeyPart(key, pattern);
+    }
+    return key;
+}
+
+RegExCache::RegExCache()
+{
+    capacity_ = DEFAULT_CAPACITY;
+}
+
+RegExCache &RegExCache::instance()
+{
+    static RegExCache instance;
+    return instance;
+}
+
+std::shared_ptr<const RegEx> RegExCache::getRegEx(const std::string &pattern, const RegExOptions &options)
+{
+    if(options.mode == RegExMode::LAZY_DFA)
+    {
+        return std::make_shared<const RegEx>(pattern, options);
+    }
+
+    const std::string key = makeRegExKey(pattern, options);
+    if(auto cached = find(key))
+    {
+        return std::static_pointer_cast<const RegEx>(cached);
+    }
+
+    // compiled outside the lock, a concurrent miss on the same key keeps whichever lands first
+    std::shared_ptr<const RegEx> compiled = std::make_shared<const RegEx>(pattern, options);
+    return std::static_pointer_cast<const RegEx>(insert(key, compiled));
+}
+
+std::shared_ptr<const RegExSet> RegExCache::getRegExSet(const std::vector<std::string> &patterns)
+{
+    const std::string key = makeRegExSetKey(patterns);
+    if(auto cached = find(key))
+    {
+        return std::static_pointer_cast<const RegExSet>(cached);
+    }
+
+    std::shared_ptr<const RegExSet> compiled = std::make_shared<const RegExSet>(patterns);
+    return std::static_pointer_cast<const RegExSet>(insert(key, compiled));
+}
+
+void RegExCache::setCapacity(size_t capacity)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_ = capacity;
+    evict();
+}
+
+size_t RegExCache::getCapacity() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return capacity_;
+}
+
+void RegExCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    index_.clear();
+    stats_ = RegExCacheStats();
+}
+
+RegExCacheStats RegExCache::getStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    RegExCacheStats stats = stats_;
+    stats.entryCount = entries_.size();
+    return stats;
+}
+
+std::shared_ptr<const void> RegExCache::find(const std::string &key)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto found = index_.find(key);
+    if(found == index_.end())
+    {
+        stats_.missCount++;
+        return nullptr;
+    }
+
+    stats_.hitCount++;
+    entries_.splice(entries_.begin(), entries_, found->second);
+    return found->second->second;
+}
+
+std::shared_ptr<const void> RegExCache::insert(const std::string &key, std::shared_ptr<const void> compiled)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto found = index_.find(key);
+    if(found != index_.end())
+    {
+        entries_.splice(entries_.begin(), entries_, found->second);
+        return found->second->second;
+    }
+
+    if(capacity_ == 0)
+    {
+        return compiled;
+    }
+
+    entries_.emplace_front(key, compiled);
+    index_[key] = entries_.begin();
+    evict();
+
+    return compiled;
+}
+
+void RegExCache::evict()
+{
+    while(entries_.size() > capacity_)
+    {
+        index_.erase(entries_.back().first);
+        entries_.pop_back();
+        stats_.evictionCount++;
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef _REGEX_CACHE_H_
+#define _REGEX_CACHE_H_
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "regEx.h"
+#include "regExSet.h"
+
+struct RegExCacheStats
+{
+    size_t hitCount = 0;
+    size_t missCount = 0;
+    size_t evictionCount = 0;
+    size_t entryCount = 0;
+};
+
+// Process-wide cache of compiled patterns keyed by pattern text and options.
+// Entries are shared and immutable, the least recently used one is dropped beyond the capacity.
+// LAZY_DFA regexes fill their state cache while matching, so they are built fresh and never cached.
+class RegExCache
+{
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 256;
+
+    RegExCache(const RegExCache&) = delete;
+    RegExCache& operator=(const RegExCache&) = delete;
+
+    static RegExCache& instance();
+
+    std::shared_ptr<const RegEx> getRegEx(const std::string &pattern, const RegExOptions &options = RegExOptions());
+    std::shared_ptr<const RegExSet> getRegExSet(const std::vector<std::string> &patterns);
+
+    // counts RegEx and RegExSet entries together, shrinking evicts right away
+    void setCapacity(size_t capacity);
+    size_t getCapacity() const;
+
+    void clear();
+    RegExCacheStats getStats() const;
+
+private:
+    RegExCache();
+    ~RegExCache() = default;
+
+    std::shared_ptr<const void> find(const std::string &key);
+    std::shared_ptr<const void> insert(const std::string &key, std::shared_ptr<const void> compiled);
+    void evict();
+
+private:
+    using LruList = std::list<std::pair<std::string, std::shared_ptr<const void>>>;
+
+    mutable std::mutex mutex_;
+    size_t capacity_;
+
+    // most recently used first
+    LruList entries_;
+    std::unordered_map<std::string, LruList::iterator> index_;
+
+    RegExCacheStats stats_;
+};
+
+#endif // _REGEX_CACHE_H_
@@ -14,17 +14,27 @@ char RegExCharNode::getCharactar() const
     return charactar_;
 }
 
-std::shared_ptr<NfaStateFragment> RegExCharNode::buildNfaStateFragment()
+NfaStateFragment RegExCharNode::buildNfaStateFragment(NFA &nfa) const
 {
-    auto startState = std::make_shared<NFAState>();
-    auto endState = std::make_shared<NFAState>();
+    int32_t startState = nfa.addState();
+    int32_t endState = nfa.addState();
 
-    startState->addTransition(charactar_, endState);
+    nfa.getState(startState).addTransition(charactar_, endState);
 
-    std::shared_ptr<NfaStateFragment> fragment = std::make_shared<NfaStateFragment>(startState, endState);
-    
-    fragment->addState(startState);
-    fragment->addState(endState);
+    return NfaStateFragment(startState, endState);
+}
+
+void RegExCharNode::collectByteClasses(ByteClassSet &byteClassSet) const
+{
+    byteClassSet.addChar(charactar_);
+}
 
-    return fragment;
+void RegExCharNode::compilePikeProgram(PikeProgram &program) const
+{
+    program.emitChar(charactar_);
+}
+
+std::shared_ptr<RegExNode> RegExCharNode::reverse() const
+{
+    return std::make_shared<RegExCharNode>(charactar_);
 }
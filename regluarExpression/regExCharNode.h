@@ -12,7 +12,10 @@ public:
 
     char getCharactar() const;
 
-    std::shared_ptr<NfaStateFragment> buildNfaStateFragment() override;
+    NfaStateFragment buildNfaStateFragment(NFA &nfa) const override;
+    void collectByteClasses(ByteClassSet &byteClassSet) const override;
+    void compilePikeProgram(PikeProgram &program) const override;
+    std::shared_ptr<RegExNode> reverse() const override;
 
 private:
     char charactar_;
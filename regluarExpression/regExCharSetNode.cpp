@@ -11,13 +11,13 @@ RegExCharSetNode::~RegExCharSetNode()
 {
 }
 
-std::shared_ptr<NfaStateFragment> RegExCharSetNode::buildNfaStateFragment()
+NfaStateFragment RegExCharSetNode::buildNfaStateFragment(NFA &nfa) const
 {
-    std::shared_ptr<NFAState> startState = std::make_shared<NFAState>();
-    std::shared_ptr<NFAState> endState = std::make_shared<NFAState>();
+    int32_t startState = nfa.addState();
+    int32_t endState = nfa.addState();
 
     std::set<char> charSetToMatch;
-    std::set<char> alphaBetSet = AlphaBet::instance().getcharactars();
+    const std::set<char> &alphaBetSet = AlphaBet::instance().getcharactars();
     if(isNegated_)
     {
         for(char character : alphaBetSet)
@@ -35,12 +35,39 @@ std::shared_ptr<NfaStateFragment> RegExCharSetNode::buildNfaStateFragment()
 
     for(char character : charSetToMatch)
     {
-        startState->addTransition(character, endState);
+        nfa.getState(startState).addTransition(character, endState);
     }
 
-    std::shared_ptr<NfaStateFragment> fragment = std::make_shared<NfaStateFragment>(startState, endState);
-    fragment->addState(startState);
-    fragment->addState(endState);
+    return NfaStateFragment(startState, endState);
+}
 
-    return fragment;
+void RegExCharSetNode::collectByteClasses(ByteClassSet &byteClassSet) const
+{
+    // a negated set splits the alphabet along the same boundary
+    byteClassSet.addCharSet(charSet_);
+}
+
+void RegExCharSetNode::compilePikeProgram(PikeProgram &program) const
+{
+    if(!isNegated_)
+    {
+        program.emitCharSet(charSet_);
+        return;
+    }
+
+    std::set<char> charSetToMatch;
+    for(char character : AlphaBet::instance().getcharactars())
+    {
+        if(charSet_.find(character) == charSet_.end())
+        {
+            charSetToMatch.insert(character);
+        }
+    }
+
+    program.emitCharSet(charSetToMatch);
+}
+
+std::shared_ptr<RegExNode> RegExCharSetNode::reverse() const
+{
+    return std::make_shared<RegExCharSetNode>(charSet_, isNegated_);
 }
@@ -11,7 +11,10 @@ public:
     explicit RegExCharSetNode(const std::set<char> &charSet, bool isNegated = false);
     virtual ~RegExCharSetNode();
 
-    std::shared_ptr<NfaStateFragment> buildNfaStateFragment() override;
+    NfaStateFragment buildNfaStateFragment(NFA &nfa) const override;
+    void collectByteClasses(ByteClassSet &byteClassSet) const override;
+    void compilePikeProgram(PikeProgram &program) const override;
+    std::shared_ptr<RegExNode> reverse() const override;
 
     const std::set<char> &getCharSet() const { return charSet_; }
     bool isNegated() const { return isNegated_; }
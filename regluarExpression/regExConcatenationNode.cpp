@@ -10,16 +10,29 @@ RegExConcatenationNode::~RegExConcatenationNode()
 {
 }
 
-std::shared_ptr<NfaStateFragment> RegExConcatenationNode::buildNfaStateFragment()
+NfaStateFragment RegExConcatenationNode::buildNfaStateFragment(NFA &nfa) const
 {
-    auto leftFragment = left_->buildNfaStateFragment();
-    auto rightFragment = right_->buildNfaStateFragment();
+    NfaStateFragment leftFragment = left_->buildNfaStateFragment(nfa);
+    NfaStateFragment rightFragment = right_->buildNfaStateFragment(nfa);
 
-    leftFragment->getEndState()->addEpsilonTransition(rightFragment->getStartState());
+    nfa.getState(leftFragment.getEndState()).addEpsilonTransition(rightFragment.getStartState());
 
-    std::shared_ptr<NfaStateFragment> concatenationFragment = std::make_shared<NfaStateFragment>(leftFragment->getStartState(), rightFragment->getEndState());
-    concatenationFragment->merge(leftFragment);
-    concatenationFragment->merge(rightFragment);
-    
-    return concatenationFragment;
+    return NfaStateFragment(leftFragment.getStartState(), rightFragment.getEndState());
+}
+
+void RegExConcatenationNode::collectByteClasses(ByteClassSet &byteClassSet) const
+{
+    left_->collectByteClasses(byteClassSet);
+    right_->collectByteClasses(byteClassSet);
+}
+
+void RegExConcatenationNode::compilePikeProgram(PikeProgram &program) const
+{
+    left_->compilePikeProgram(program);
+    right_->compilePikeProgram(program);
+}
+
+std::shared_ptr<RegExNode> RegExConcatenationNode::reverse() const
+{
+    return std::make_shared<RegExConcatenationNode>(right_->reverse(), left_->reverse());
 }
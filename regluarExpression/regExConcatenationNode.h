@@ -11,7 +11,10 @@ public:
     explicit RegExConcatenationNode(std::shared_ptr<RegExNode> left, std::shared_ptr<RegExNode> right);
     virtual ~RegExConcatenationNode();
 
-    std::shared_ptr<NfaStateFragment> buildNfaStateFragment() override;
+    NfaStateFragment buildNfaStateFragment(NFA &nfa) const override;
+    void collectByteClasses(ByteClassSet &byteClassSet) const override;
+    void compilePikeProgram(PikeProgram &program) const override;
+    std::shared_ptr<RegExNode> reverse() const override;
 
     std::shared_ptr<RegExNode> getLeft() const { return left_; };
     std::shared_ptr<RegExNode> getRight() const { return right_; };
@@ -9,23 +9,42 @@ RegExKleeneStarNode::~RegExKleeneStarNode()
 {
 }
 
-std::shared_ptr<NfaStateFragment> RegExKleeneStarNode::buildNfaStateFragment()
+NfaStateFragment RegExKleeneStarNode::buildNfaStateFragment(NFA &nfa) const
 {
-    auto fragment = node_->buildNfaStateFragment();
-    auto startState = std::make_shared<NFAState>();
-    auto endState = std::make_shared<NFAState>();
+    NfaStateFragment fragment = node_->buildNfaStateFragment(nfa);
+    int32_t startState = nfa.addState();
+    int32_t endState = nfa.addState();
 
-    startState->addEpsilonTransition(fragment->getStartState());
-    startState->addEpsilonTransition(endState);
+    nfa.getState(startState).addEpsilonTransition(fragment.getStartState());
+    nfa.getState(startState).addEpsilonTransition(endState);
 
-    fragment->getEndState()->addEpsilonTransition(endState);
-    fragment->getEndState()->addEpsilonTransition(fragment->getStartState());
+    nfa.getState(fragment.getEndState()).addEpsilonTransition(endState);
+    nfa.getState(fragment.getEndState()).addEpsilonTransition(fragment.getStartState());
 
-    std::shared_ptr<NfaStateFragment> kleeneFragment = std::make_shared<NfaStateFragment>(startState, endState);
-    kleeneFragment->addState(startState);
-    kleeneFragment->addState(endState);
+    return NfaStateFragment(startState, endState);
+}
 
-    kleeneFragment->merge(fragment);
+void RegExKleeneStarNode::collectByteClasses(ByteClassSet &byteClassSet) const
+{
+    node_->collectByteClasses(byteClassSet);
+}
+
+void RegExKleeneStarNode::compilePikeProgram(PikeProgram &program) const
+{
+    // L1: split L2, L3
+    // L2: node
+    //     jump L1
+    // L3:
+    int32_t split = program.emitSplit();
 
-    return kleeneFragment;
+    program.patchX(split, program.getNextPc());
+    node_->compilePikeProgram(program);
+    program.emitJump(split);
+
+    program.patchY(split, program.getNextPc());
+}
+
+std::shared_ptr<RegExNode> RegExKleeneStarNode::reverse() const
+{
+    return std::make_shared<RegExKleeneStarNode>(node_->reverse());
 }
@@ -2,6 +2,9 @@
 #define _REGEX_NODE_H_
 
 #include "nfaStateFragment.h"
+#include "byteClassSet.h"
+#include "pikeProgram.h"
+#include <memory>
 
 class RegExNode
 {
@@ -9,7 +12,12 @@ public:
     explicit RegExNode();
     virtual ~RegExNode();
 
-    virtual std::shared_ptr<NfaStateFragment> buildNfaStateFragment() = 0;
+    virtual NfaStateFragment buildNfaStateFragment(NFA &nfa) const = 0;
+    virtual void collectByteClasses(ByteClassSet &byteClassSet) const = 0;
+    virtual void compilePikeProgram(PikeProgram &program) const = 0;
+
+    // the tree matching the mirrored strings, used to find match starts scanning backwards
+    virtual std::shared_ptr<RegExNode> reverse() const = 0;
 };
 
 #endif // _REGEX_NODE_H_
\ No newline at end of file
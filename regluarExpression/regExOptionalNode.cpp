@@ -9,23 +9,39 @@ RegExOptionalNode::~RegExOptionalNode()
 {
 }
 
-std::shared_ptr<NfaStateFragment> RegExOptionalNode::buildNfaStateFragment()
+NfaStateFragment RegExOptionalNode::buildNfaStateFragment(NFA &nfa) const
 {
-    auto fragment = node_->buildNfaStateFragment();
-    auto startState = std::make_shared<NFAState>();
-    auto endState = std::make_shared<NFAState>();
+    NfaStateFragment fragment = node_->buildNfaStateFragment(nfa);
+    int32_t startState = nfa.addState();
+    int32_t endState = nfa.addState();
 
-    startState->addEpsilonTransition(fragment->getStartState());
-    startState->addEpsilonTransition(endState);
+    nfa.getState(startState).addEpsilonTransition(fragment.getStartState());
+    nfa.getState(startState).addEpsilonTransition(endState);
 
-    fragment->getEndState()->addEpsilonTransition(endState);
+    nfa.getState(fragment.getEndState()).addEpsilonTransition(endState);
 
-    std::shared_ptr<NfaStateFragment> optionalFragment = std::make_shared<NfaStateFragment>(startState, endState);
-    optionalFragment->addState(startState);
-    optionalFragment->addState(endState);
+    return NfaStateFragment(startState, endState);
+}
+
+void RegExOptionalNode::collectByteClasses(ByteClassSet &byteClassSet) const
+{
+    node_->collectByteClasses(byteClassSet);
+}
 
-    optionalFragment->merge(fragment);
+void RegExOptionalNode::compilePikeProgram(PikeProgram &program) const
+{
+    //     split L1, L2
+    // L1: node
+    // L2:
+    int32_t split = program.emitSplit();
+
+    program.patchX(split, program.getNextPc());
+    node_->compilePikeProgram(program);
 
-    return optionalFragment;
+    program.patchY(split, program.getNextPc());
 }
 
+std::shared_ptr<RegExNode> RegExOptionalNode::reverse() const
+{
+    return std::make_shared<RegExOptionalNode>(node_->reverse());
+}
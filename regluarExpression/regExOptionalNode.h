@@ -10,7 +10,10 @@ public:
     explicit RegExOptionalNode(std::shared_ptr<RegExNode> node);
     virtual ~RegExOptionalNode();
 
-    std::shared_ptr<NfaStateFragment> buildNfaStateFragment() override;
+    NfaStateFragment buildNfaStateFragment(NFA &nfa) const override;
+    void collectByteClasses(ByteClassSet &byteClassSet) const override;
+    void compilePikeProgram(PikeProgram &program) const override;
+    std::shared_ptr<RegExNode> reverse() const override;
 
     std::shared_ptr<RegExNode> getNode() const { return node_; };
 
@@ -9,22 +9,38 @@ RegExPlusNode::~RegExPlusNode()
 {
 }
 
-std::shared_ptr<NfaStateFragment> RegExPlusNode::buildNfaStateFragment()
+NfaStateFragment RegExPlusNode::buildNfaStateFragment(NFA &nfa) const
 {
-    auto fragment = node_->buildNfaStateFragment();
-    auto startState = std::make_shared<NFAState>();
-    auto endState = std::make_shared<NFAState>();
+    NfaStateFragment fragment = node_->buildNfaStateFragment(nfa);
+    int32_t startState = nfa.addState();
+    int32_t endState = nfa.addState();
 
-    startState->addEpsilonTransition(fragment->getStartState());
+    nfa.getState(startState).addEpsilonTransition(fragment.getStartState());
 
-    fragment->getEndState()->addEpsilonTransition(fragment->getStartState());
-    fragment->getEndState()->addEpsilonTransition(endState);
+    nfa.getState(fragment.getEndState()).addEpsilonTransition(fragment.getStartState());
+    nfa.getState(fragment.getEndState()).addEpsilonTransition(endState);
 
-    std::shared_ptr<NfaStateFragment> plusFragment = std::make_shared<NfaStateFragment>(startState, endState);
-    plusFragment->addState(startState);
-    plusFragment->addState(endState);
+    return NfaStateFragment(startState, endState);
+}
 
-    plusFragment->merge(fragment);
+void RegExPlusNode::collectByteClasses(ByteClassSet &byteClassSet) const
+{
+    node_->collectByteClasses(byteClassSet);
+}
 
-    return plusFragment;
+void RegExPlusNode::compilePikeProgram(PikeProgram &program) const
+{
+    // L1: node
+    //     split L1, L2
+    // L2:
+    int32_t start = program.getNextPc();
+    node_->compilePikeProgram(program);
+
+    int32_t split = program.emitSplit(start);
+    program.patchY(split, program.getNextPc());
+}
+
+std::shared_ptr<RegExNode> RegExPlusNode::reverse() const
+{
+    return std::make_shared<RegExPlusNode>(node_->reverse());
 }
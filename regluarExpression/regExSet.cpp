@@ -0,0 +1,142 @@
+#include "regExSet.h"
+#include "alphaBet.h"
+#include "lazyDfa.h"
+#include "regExParser.h"
+#include "regExSimplifier.h"
+#include <stdexcept>
+
+RegExSet::RegExSet(const std::vector<std::string> &patterns)
+{
+    std::vector<std::shared_ptr<RegExNode>> roots;
+    for(const auto &pattern : patterns)
+    {
+        RegExParser regExParser(pattern);
+        roots.push_back(regExParser.getRoot());
+    }
+
+    buildDFA(roots);
+}
+
+RegExSet::RegExSet(const std::vector<std::shared_ptr<RegExNode>> &roots)
+{
+    buildDFA(roots);
+}
+
+RegExSet::RegExSet(DFATable dfaTable, size_t patternCount)
+{
+    // every accept tag indexes a pattern, e.g. the token type table of the Lexer
+    for(size_t state = 0; state < dfaTable.getStateCount(); state++)
+    {
+        int32_t acceptTag = dfaTable.getAcceptTag(static_cast<int32_t>(state));
+        if(acceptTag != DFATable::NO_ACCEPT && static_cast<size_t>(acceptTag) >= patternCount)
+        {
+            throw std::runtime_error("DFA accept tag " + std::to_string(acceptTag) + " is not one of the " + std::to_string(patternCount) + " patterns");
+        }
+    }
+
+    dfaTable_ = std::move(dfaTable);
+    patternCount_ = patternCount;
+
+    stats_.dfaStateCount = dfaTable_.getStateCount();
+    stats_.minimizedDfaStateCount = dfaTable_.getStateCount();
+    stats_.byteClassCount = dfaTable_.getClassCount();
+
+    accelerator_ = StateAccelerator(dfaTable_);
+    stats_.acceleratedStateCount = accelerator_.getAcceleratedStateCount();
+}
+
+std::optional<RegExSetMatch> RegExSet::match(std::string_view str) const
+{
+    int32_t currentState = dfaTable_.getStartState();
+    std::optional<RegExSetMatch> matched = std::nullopt;
+
+    if(dfaTable_.isEndState(currentState))
+    {
+        matched = RegExSetMatch{0, static_cast<size_t>(dfaTable_.getAcceptTag(currentState))};
+    }
+
+    const char *data = str.data();
+    const size_t size = str.size();
+
+    for(size_t index = 0; index < size; index++)
+    {
+        int32_t nextState = dfaTable_.run(currentState, data[index]);
+        if(nextState == currentState && accelerator_.isAccelerable(currentState))
+        {
+            index = accelerator_.skip(currentState, data, index + 1, size) - 1;
+        }
+        currentState = nextState;
+
+        if(currentState == DFATable::DEAD_STATE)
+        {
+            break;
+        }
+
+        if(dfaTable_.isEndState(currentState))
+        {
+            matched = RegExSetMatch{index + 1, static_cast<size_t>(dfaTable_.getAcceptTag(currentState))};
+        }
+    }
+
+    return matched;
+}
+
+size_t RegExSet::getPatternCount() const
+{
+    return patternCount_;
+}
+
+const RegExStats &RegExSet::getStats() const
+{
+    return stats_;
+}
+
+const DFATable &RegExSet::getDFATable() const
+{
+    return dfaTable_;
+}
+
+void RegExSet::save(const std::string &path) const
+{
+    dfaTable_.save(path);
+}
+
+void RegExSet::buildDFA(const std::vector<std::shared_ptr<RegExNode>> &parsedRoots)
+{
+    patternCount_ = parsedRoots.size();
+
+    std::vector<std::shared_ptr<RegExNode>> roots;
+    for(const auto &root : parsedRoots)
+    {
+        roots.push_back(RegExSimplifier::simplify(root));
+    }
+
+    ByteClassSet byteClassSet;
+    byteClassSet.addCharSet(AlphaBet::instance().getcharactars());
+    for(const auto &root : roots)
+    {
+        root->collectByteClasses(byteClassSet);
+    }
+
+    // one start state with an epsilon edge into every pattern, each end state tagged with its pattern id
+    NFA nfa;
+    int32_t startState = nfa.addState();
+    for(size_t patternId = 0; patternId < roots.size(); patternId++)
+    {
+        NfaStateFragment fragment = roots[patternId]->buildNfaStateFragment(nfa);
+
+        nfa.getState(startState).addEpsilonTransition(fragment.getStartState());
+        nfa.getState(fragment.getEndState()).setAcceptTag(static_cast<int32_t>(patternId));
+    }
+
+    LazyDFA subsetBuilder(nfa, startState, byteClassSet);
+    dfaTable_ = std::move(*subsetBuilder.toDFATable());
+
+    stats_.dfaStateCount = dfaTable_.getStateCount();
+    dfaTable_ = dfaTable_.minimize();
+    stats_.minimizedDfaStateCount = dfaTable_.getStateCount();
+    stats_.byteClassCount = dfaTable_.getClassCount();
+
+    accelerator_ = StateAccelerator(dfaTable_);
+    stats_.acceleratedStateCount = accelerator_.getAcceleratedStateCount();
+}
@@ -0,0 +1,52 @@
+#ifndef _REGEX_SET_H_
+#define _REGEX_SET_H_
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "regExNode.h"
+#include "regEx.h"
+#include "dfaTable.h"
+#include "stateAccelerator.h"
+
+struct RegExSetMatch
+{
+    size_t length;
+    size_t patternId;
+};
+
+// Many patterns compiled into one DFA, every accept state carries the id of the winning pattern.
+class RegExSet
+{
+public:
+    explicit RegExSet(const std::vector<std::string>& patterns);
+    explicit RegExSet(const std::vector<std::shared_ptr<RegExNode>>& roots);
+    // a prebuilt table (e.g. from StaticRegExCompiler), accept tags are pattern ids;
+    // throws runtime_error on a tag that is not below patternCount
+    RegExSet(DFATable dfaTable, size_t patternCount);
+    ~RegExSet() = default;
+
+    //NOTICE: Longest Prefix Match, on equal length the pattern added first wins
+    std::optional<RegExSetMatch> match(std::string_view str) const;
+
+    size_t getPatternCount() const;
+    const RegExStats& getStats() const;
+    const DFATable& getDFATable() const;
+
+    // writes the DFA for RegExSet(DFATable::load(path), patternCount)
+    void save(const std::string& path) const;
+
+private:
+    void buildDFA(const std::vector<std::shared_ptr<RegExNode>>& parsedRoots);
+
+private:
+    DFATable dfaTable_;
+    StateAccelerator accelerator_;
+    size_t patternCount_;
+
+    RegExStats stats_;
+};
+
+#endif // _REGEX_SET_H_
@@ -0,0 +1,323 @@
+#include "regExSimplifier.h"
+#include "alphaBet.h"
+#include "regExAlternationNode.h"
+#include "regExCharNode.h"
+#include "regExCharSetNode.h"
+#include "regExConcatenationNode.h"
+#include "regExKleeneStarNode.h"
+#include "regExOptionalNode.h"
+#include "regExPlusNode.h"
+#include <array>
+#include <set>
+#include <typeinfo>
+
+// the node classes have no subclasses, an exact type test is much cheaper than dynamic_cast
+template <typename T>
+static const T *nodeAs(const RegExNode *node)
+{
+    return (node != nullptr && typeid(*node) == typeid(T)) ? static_cast<const T *>(node) : nullptr;
+}
+
+std::shared_ptr<RegExNode> RegExSimplifier::simplify(const std::shared_ptr<RegExNode> &node)
+{
+    // flatten the parsed chain first, simplifying every level of it would redo the factoring each time
+    if(nodeAs<RegExConcatenationNode>(node.get()))
+    {
+        NodeList parsed;
+        flattenConcatenation(node, parsed);
+
+        NodeList sequence;
+        for(const auto &item : parsed)
+        {
+            flattenConcatenation(simplify(item), sequence);
+        }
+
+        return buildConcatenation(sequence, 0);
+    }
+
+    if(nodeAs<RegExAlternationNode>(node.get()))
+    {
+        NodeList parsed;
+        flattenAlternation(node, parsed);
+
+        NodeList alternatives;
+        for(const auto &alternative : parsed)
+        {
+            flattenAlternation(simplify(alternative), alternatives);
+        }
+
+        return simplifyAlternatives(alternatives);
+    }
+
+    if(auto kleeneStarNode = nodeAs<RegExKleeneStarNode>(node.get()))
+    {
+        return makeKleeneStar(simplify(kleeneStarNode->getNode()));
+    }
+
+    if(auto plusNode = nodeAs<RegExPlusNode>(node.get()))
+    {
+        return makePlus(simplify(plusNode->getNode()));
+    }
+
+    if(auto optionalNode = nodeAs<RegExOptionalNode>(node.get()))
+    {
+        return makeOptional(simplify(optionalNode->getNode()));
+    }
+
+    return node;
+}
+
+std::shared_ptr<RegExNode> RegExSimplifier::simplifyAlternatives(const NodeList &alternatives)
+{
+    std::vector<NodeList> sequences(alternatives.size());
+    std::vector<SequenceTail> tails;
+    for(size_t i = 0; i < alternatives.size(); i++)
+    {
+        flattenConcatenation(alternatives[i], sequences[i]);
+        tails.push_back(SequenceTail{&sequences[i], 0});
+    }
+
+    return factorPrefixes(tails);
+}
+
+std::shared_ptr<RegExNode> RegExSimplifier::factorPrefixes(const std::vector<SequenceTail> &tails)
+{
+    struct PrefixGroup
+    {
+        size_t slot = 0;
+        std::vector<SequenceTail> rests;
+        bool hasEmptyRest = false;
+    };
+
+    auto leadChar = [](const SequenceTail &tail)
+    {
+        return nodeAs<RegExCharNode>((*tail.items)[tail.first].get());
+    };
+
+    std::array<uint8_t, 256> leadCounts = {};
+    for(const auto &tail : tails)
+    {
+        if(auto charNode = leadChar(tail))
+        {
+            uint8_t &count = leadCounts[static_cast<unsigned char>(charNode->getCharactar())];
+            count = (count < 2) ? count + 1 : 2;
+        }
+    }
+
+    // a group takes the slot of its first alternative
+    NodeList result;
+    std::vector<PrefixGroup> groups;
+    std::array<int, 256> groupIndex;
+    groupIndex.fill(-1);
+    for(const auto &tail : tails)
+    {
+        auto charNode = leadChar(tail);
+        const unsigned char character = charNode ? static_cast<unsigned char>(charNode->getCharactar()) : 0;
+        if(!charNode || leadCounts[character] < 2)
+        {
+            result.push_back(buildConcatenation(*tail.items, tail.first));
+            continue;
+        }
+
+        if(groupIndex[character] < 0)
+        {
+            groupIndex[character] = static_cast<int>(groups.size());
+            groups.emplace_back();
+            groups.back().slot = result.size();
+            result.push_back((*tail.items)[tail.first]);
+        }
+
+        PrefixGroup &group = groups[groupIndex[character]];
+        if(tail.first + 1 == tail.items->size())
+        {
+            group.hasEmptyRest = true;
+        }
+        else
+        {
+            group.rests.push_back(SequenceTail{tail.items, tail.first + 1});
+        }
+    }
+
+    for(const auto &group : groups)
+    {
+        if(group.rests.empty())
+        {
+            continue;
+        }
+
+        std::shared_ptr<RegExNode> rest = factorPrefixes(group.rests);
+        if(group.hasEmptyRest)
+        {
+            rest = makeOptional(rest);
+        }
+
+        // rest is already a right-leaning chain, so this stays flat
+        result[group.slot] = std::make_shared<RegExConcatenationNode>(result[group.slot], rest);
+    }
+
+    // after factoring: a merged char set would hide the leading char of ">" in ">=|>"
+    return buildAlternation(mergeCharSets(result), 0);
+}
+
+RegExSimplifier::NodeList RegExSimplifier::mergeCharSets(const NodeList &alternatives)
+{
+    std::set<char> charSet;
+    size_t setCount = 0;
+    size_t firstSlot = 0;
+
+    for(size_t i = 0; i < alternatives.size(); i++)
+    {
+        if(auto charNode = nodeAs<RegExCharNode>(alternatives[i].get()))
+        {
+            charSet.insert(charNode->getCharactar());
+        }
+        else if(auto charSetNode = nodeAs<RegExCharSetNode>(alternatives[i].get()))
+        {
+            // a negated set stands for the rest of the alphabet
+            const std::set<char> &items = charSetNode->getCharSet();
+            if(charSetNode->isNegated())
+            {
+                for(char character : AlphaBet::instance().getcharactars())
+                {
+                    if(items.find(character) == items.end())
+                    {
+                        charSet.insert(character);
+                    }
+                }
+            }
+            else
+            {
+                charSet.insert(items.begin(), items.end());
+            }
+        }
+        else
+        {
+            continue;
+        }
+
+        if(setCount++ == 0)
+        {
+            firstSlot = i;
+        }
+    }
+
+    if(setCount < 2)
+    {
+        return alternatives;
+    }
+
+    NodeList result;
+    for(size_t i = 0; i < alternatives.size(); i++)
+    {
+        if(i == firstSlot)
+        {
+            if(charSet.size() == 1)
+            {
+                result.push_back(std::make_shared<RegExCharNode>(*charSet.begin()));
+            }
+            else
+            {
+                result.push_back(std::make_shared<RegExCharSetNode>(charSet));
+            }
+        }
+        else if(!nodeAs<RegExCharNode>(alternatives[i].get()) && !nodeAs<RegExCharSetNode>(alternatives[i].get()))
+        {
+            result.push_back(alternatives[i]);
+        }
+    }
+
+    return result;
+}
+
+void RegExSimplifier::flattenConcatenation(const std::shared_ptr<RegExNode> &node, NodeList &sequence)
+{
+    if(auto concatenationNode = nodeAs<RegExConcatenationNode>(node.get()))
+    {
+        flattenConcatenation(concatenationNode->getLeft(), sequence);
+        flattenConcatenation(concatenationNode->getRight(), sequence);
+        return;
+    }
+
+    sequence.push_back(node);
+}
+
+void RegExSimplifier::flattenAlternation(const std::shared_ptr<RegExNode> &node, NodeList &alternatives)
+{
+    if(auto alternationNode = nodeAs<RegExAlternationNode>(node.get()))
+    {
+        flattenAlternation(alternationNode->getLeft(), alternatives);
+        flattenAlternation(alternationNode->getRight(), alternatives);
+        return;
+    }
+
+    alternatives.push_back(node);
+}
+
+std::shared_ptr<RegExNode> RegExSimplifier::buildConcatenation(const NodeList &sequence, size_t first)
+{
+    if(first + 1 == sequence.size())
+    {
+        return sequence[first];
+    }
+
+    return std::make_shared<RegExConcatenationNode>(sequence[first], buildConcatenation(sequence, first + 1));
+}
+
+std::shared_ptr<RegExNode> RegExSimplifier::buildAlternation(const NodeList &alternatives, size_t first)
+{
+    if(first + 1 == alternatives.size())
+    {
+        return alternatives[first];
+    }
+
+    return std::make_shared<RegExAlternationNode>(alternatives[first], buildAlternation(alternatives, first + 1));
+}
+
+std::shared_ptr<RegExNode> RegExSimplifier::makeKleeneStar(const std::shared_ptr<RegExNode> &node)
+{
+    // x** = x+* = x?* = x*
+    if(nodeAs<RegExKleeneStarNode>(node.get()))
+    {
+        return node;
+    }
+    if(auto plusNode = nodeAs<RegExPlusNode>(node.get()))
+    {
+        return std::make_shared<RegExKleeneStarNode>(plusNode->getNode());
+    }
+    if(auto optionalNode = nodeAs<RegExOptionalNode>(node.get()))
+    {
+        return std::make_shared<RegExKleeneStarNode>(optionalNode->getNode());
+    }
+
+    return std::make_shared<RegExKleeneStarNode>(node);
+}
+
+std::shared_ptr<RegExNode> RegExSimplifier::makePlus(const std::shared_ptr<RegExNode> &node)
+{
+    // x++ = x+, x*+ = x*, x?+ = x*
+    if(nodeAs<RegExPlusNode>(node.get()) || nodeAs<RegExKleeneStarNode>(node.get()))
+    {
+        return node;
+    }
+    if(auto optionalNode = nodeAs<RegExOptionalNode>(node.get()))
+    {
+        return std::make_shared<RegExKleeneStarNode>(optionalNode->getNode());
+    }
+
+    return std::make_shared<RegExPlusNode>(node);
+}
+
+std::shared_ptr<RegExNode> RegExSimplifier::makeOptional(const std::shared_ptr<RegExNode> &node)
+{
+    // x?? = x?, x*? = x*, x+? = x*
+    if(nodeAs<RegExOptionalNode>(node.get()) || nodeAs<RegExKleeneStarNode>(node.get()))
+    {
+        return node;
+    }
+    if(auto plusNode = nodeAs<RegExPlusNode>(node.get()))
+    {
+        return std::make_shared<RegExKleeneStarNode>(plusNode->getNode());
+    }
+
+    return std::make_shared<RegExOptionalNode>(node);
+}
@@ -0,0 +1,44 @@
+#ifndef _REGEX_SIMPLIFIER_H_
+#define _REGEX_SIMPLIFIER_H_
+
+#include <memory>
+#include <vector>
+
+class RegExNode;
+
+// Rewrites a parsed tree into an equivalent smaller one before the NFA is built:
+//   a|b|[cd]     -> [abcd]
+//   abc|abd|a    -> a(b[cd])?
+//   (x*)* (x+)*  -> x*, and the other nested quantifiers likewise
+// Concatenations and alternations come out flattened into right-leaning chains.
+// Leaf nodes are shared with the input tree, which is left as it is.
+class RegExSimplifier
+{
+public:
+    static std::shared_ptr<RegExNode> simplify(const std::shared_ptr<RegExNode> &node);
+
+private:
+    using NodeList = std::vector<std::shared_ptr<RegExNode>>;
+
+    // the tail of a flattened alternative, factoring works on these so nothing is rebuilt per level
+    struct SequenceTail
+    {
+        const NodeList *items;
+        size_t first;
+    };
+
+    static std::shared_ptr<RegExNode> simplifyAlternatives(const NodeList &alternatives);
+    static std::shared_ptr<RegExNode> factorPrefixes(const std::vector<SequenceTail> &tails);
+    static NodeList mergeCharSets(const NodeList &alternatives);
+
+    static void flattenConcatenation(const std::shared_ptr<RegExNode> &node, NodeList &sequence);
+    static void flattenAlternation(const std::shared_ptr<RegExNode> &node, NodeList &alternatives);
+    static std::shared_ptr<RegExNode> buildConcatenation(const NodeList &sequence, size_t first);
+    static std::shared_ptr<RegExNode> buildAlternation(const NodeList &alternatives, size_t first);
+
+    static std::shared_ptr<RegExNode> makeKleeneStar(const std::shared_ptr<RegExNode> &node);
+    static std::shared_ptr<RegExNode> makePlus(const std::shared_ptr<RegExNode> &node);
+    static std::shared_ptr<RegExNode> makeOptional(const std::shared_ptr<RegExNode> &node);
+};
+
+#endif // _REGEX_SIMPLIFIER_H_
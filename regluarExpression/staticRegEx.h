@@ -0,0 +1,754 @@
+#ifndef _STATIC_REGEX_H_
+#define _STATIC_REGEX_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include "dfaTable.h"
+
+// Compile-time regex: the same grammar as RegExParser (and the same AlphaBet), turned into a DFA
+// by a constexpr Glushkov construction, so the tables end up in the binary:
+//
+//     constexpr std::string_view PATTERNS[] = {"if", "\\w+"};
+//     constexpr auto DFA = StaticRegExCompiler<64, 64, 32>::compile(PATTERNS);
+//
+// Every character of a pattern becomes a position, a DFA state is the set of positions just
+// matched. The accept tag of a state is the lowest pattern id among its final positions, as in RegExSet.
+// Errors throw, which turns a bad pattern (or too small a limit) into a compile error.
+
+template <size_t MaxStates, size_t MaxClasses>
+struct StaticDFA
+{
+    uint8_t byteClassMap[DFATable::BYTE_COUNT] = {};
+    size_t classCount = 0;
+    size_t stateCount = 0;
+
+    // row per state, classCount wide
+    int32_t transitions[MaxStates * MaxClasses] = {};
+    int32_t acceptTags[MaxStates] = {};
+
+    constexpr int32_t run(int32_t state, char input) const
+    {
+        return transitions[static_cast<size_t>(state) * classCount + byteClassMap[static_cast<unsigned char>(input)]];
+    }
+
+    //NOTICE: Longest Prefix Match, any pattern
+    constexpr std::optional<size_t> match(std::string_view str) const
+    {
+        int32_t state = 0;
+        std::optional<size_t> matched = std::nullopt;
+
+        if(acceptTags[state] != DFATable::NO_ACCEPT)
+        {
+            matched = 0;
+        }
+
+        for(size_t index = 0; index < str.size(); index++)
+        {
+            state = run(state, str[index]);
+            if(state == DFATable::DEAD_STATE)
+            {
+                break;
+            }
+
+            if(acceptTags[state] != DFATable::NO_ACCEPT)
+            {
+                matched = index + 1;
+            }
+        }
+
+        return matched;
+    }
+
+    // copies the tables into a runtime DFATable, no regex work involved
+    DFATable toDFATable() const
+    {
+        std::array<uint8_t, DFATable::BYTE_COUNT> classMap{};
+        for(size_t i = 0; i < DFATable::BYTE_COUNT; i++)
+        {
+            classMap[i] = byteClassMap[i];
+        }
+
+        DFATable table(classMap, classCount);
+        for(size_t state = 0; state < stateCount; state++)
+        {
+            table.addState(acceptTags[state]);
+        }
+        for(size_t state = 0; state < stateCount; state++)
+        {
+            for(size_t byteClass = 0; byteClass < classCount; byteClass++)
+            {
+                table.addTransition(static_cast<int32_t>(state), static_cast<uint8_t>(byteClass), transitions[state * classCount + byteClass]);
+            }
+        }
+
+        return table;
+    }
+};
+
+template <size_t MaxPositions, size_t MaxStates, size_t MaxClasses>
+class StaticRegExCompiler
+{
+public:
+    using DFA = StaticDFA<MaxStates, MaxClasses>;
+
+    template <size_t PatternCount>
+    static constexpr DFA compile(const std::string_view (&patterns)[PatternCount])
+    {
+        StaticRegExCompiler compiler;
+        for(size_t patternId = 0; patternId < PatternCount; patternId++)
+        {
+            compiler.addPattern(patterns[patternId], static_cast<int32_t>(patternId));
+        }
+
+        return compiler.buildDFA();
+    }
+
+private:
+    static constexpr size_t POSITION_WORDS = (MaxPositions + 63) / 64;
+
+    struct CharSet
+    {
+        uint64_t bits[4] = {};
+
+        constexpr void add(unsigned char c)
+        {
+            bits[c >> 6] |= uint64_t(1) << (c & 63);
+        }
+
+        constexpr bool has(unsigned char c) const
+        {
+            return (bits[c >> 6] >> (c & 63)) & 1;
+        }
+
+        constexpr void addSet(const CharSet &other)
+        {
+            for(size_t i = 0; i < 4; i++)
+            {
+                bits[i] |= other.bits[i];
+            }
+        }
+    };
+
+    struct PositionSet
+    {
+        uint64_t words[POSITION_WORDS] = {};
+
+        constexpr void add(size_t position)
+        {
+            words[position >> 6] |= uint64_t(1) << (position & 63);
+        }
+
+        constexpr bool has(size_t position) const
+        {
+            return (words[position >> 6] >> (position & 63)) & 1;
+        }
+
+        constexpr void addSet(const PositionSet &other)
+        {
+            for(size_t i = 0; i < POSITION_WORDS; i++)
+            {
+                words[i] |= other.words[i];
+            }
+        }
+
+        constexpr PositionSet intersect(const PositionSet &other) const
+        {
+            PositionSet result;
+            for(size_t i = 0; i < POSITION_WORDS; i++)
+            {
+                result.words[i] = words[i] & other.words[i];
+            }
+            return result;
+        }
+
+        constexpr bool empty() const
+        {
+            for(size_t i = 0; i < POSITION_WORDS; i++)
+            {
+                if(words[i] != 0)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        constexpr bool equals(const PositionSet &other) const
+        {
+            for(size_t i = 0; i < POSITION_WORDS; i++)
+            {
+                if(words[i] != other.words[i])
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+
+    // what a sub-expression contributes to the position automaton
+    struct Fragment
+    {
+        bool nullable = false;
+        PositionSet first;
+        PositionSet last;
+    };
+
+    // AlphaBet
+    static constexpr bool isInAlphaBet(unsigned char c)
+    {
+        return (c >= 32 && c <= 126) || c == '\t' || c == '\n' || c == '\r';
+    }
+
+    static constexpr CharSet whiteSpaceChar()
+    {
+        CharSet set;
+        set.add(' ');
+        set.add('\t');
+        set.add('\n');
+        set.add('\r');
+        return set;
+    }
+
+    static constexpr CharSet digitChar()
+    {
+        CharSet set;
+        for(unsigned char c = '0'; c <= '9'; c++)
+        {
+            set.add(c);
+        }
+        return set;
+    }
+
+    static constexpr CharSet wordChar()
+    {
+        CharSet set = digitChar();
+        for(unsigned char c = 'a'; c <= 'z'; c++)
+        {
+            set.add(c);
+        }
+        for(unsigned char c = 'A'; c <= 'Z'; c++)
+        {
+            set.add(c);
+        }
+        set.add('_');
+        return set;
+    }
+
+    // RegExParser character classes
+    static constexpr bool isMetaChar(char c)
+    {
+        return c == '*' || c == '+' || c == '?' || c == '|' || c == '(' || c == ')' ||
+               c == '[' || c == ']' || c == '\\' || c == '-' || c == '^';
+    }
+
+    static constexpr bool isLiteralChar(char c)
+    {
+        return !isMetaChar(c);
+    }
+
+    static constexpr bool isEscapedLiteralChar(char c)
+    {
+        return isMetaChar(c) || c == 's' || c == 'd' || c == 'w' || c == 't' || c == 'n' || c == 'r';
+    }
+
+    static constexpr bool isLetter(char c)
+    {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+    }
+
+    static constexpr bool isDigit(char c)
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    static constexpr bool isAlphaNumber(char c)
+    {
+        return isLetter(c) || isDigit(c);
+    }
+
+    static constexpr bool isInFactorFirstSet(char c)
+    {
+        return c == '\\' || c == '[' || c == '(' || isLiteralChar(c);
+    }
+
+    static constexpr bool isInTermFollowSet(char c)
+    {
+        return c == '|' || c == '\0' || c == ')';
+    }
+
+    constexpr char peekChar(size_t offset = 0) const
+    {
+        return (index_ + offset >= pattern_.size()) ? '\0' : pattern_[index_ + offset];
+    }
+
+    constexpr bool isEnd(size_t offset = 0) const
+    {
+        return index_ + offset >= pattern_.size();
+    }
+
+    constexpr void consumeChar()
+    {
+        index_++;
+    }
+
+    constexpr void addPattern(std::string_view pattern, int32_t patternId)
+    {
+        pattern_ = pattern;
+        index_ = 0;
+
+        Fragment fragment = parseRegEx();
+        if(!isEnd())
+        {
+            throw std::logic_error("Invalid regex: Unexpected characters found after the end of the expression.");
+        }
+
+        for(size_t position = 0; position < positionCount_; position++)
+        {
+            if(fragment.last.has(position))
+            {
+                positionAcceptTags_[position] = patternId;
+            }
+        }
+
+        startFollow_.addSet(fragment.first);
+        if(fragment.nullable && startAcceptTag_ == DFATable::NO_ACCEPT)
+        {
+            startAcceptTag_ = patternId;
+        }
+    }
+
+    constexpr Fragment addPosition(const CharSet &chars)
+    {
+        if(positionCount_ >= MaxPositions)
+        {
+            throw std::logic_error("StaticRegExCompiler: too many positions, raise MaxPositions");
+        }
+
+        // characters outside the alphabet never match, as at runtime
+        size_t position = positionCount_++;
+        positionAcceptTags_[position] = DFATable::NO_ACCEPT;
+        for(unsigned c = 0; c < DFATable::BYTE_COUNT; c++)
+        {
+            if(chars.has(static_cast<unsigned char>(c)) && isInAlphaBet(static_cast<unsigned char>(c)))
+            {
+                positionChars_[position].add(static_cast<unsigned char>(c));
+            }
+        }
+
+        Fragment fragment;
+        fragment.first.add(position);
+        fragment.last.add(position);
+        return fragment;
+    }
+
+    constexpr void addFollow(const PositionSet &from, const PositionSet &to)
+    {
+        for(size_t position = 0; position < positionCount_; position++)
+        {
+            if(from.has(position))
+            {
+                positionFollow_[position].addSet(to);
+            }
+        }
+    }
+
+    constexpr Fragment parseRegEx()
+    {
+        if(isEnd())
+        {
+            throw std::logic_error("Invalid regex: Empty or incomplete expression.");
+        }
+
+        Fragment fragment = parseTerm();
+
+        while(peekChar() == '|')
+        {
+            consumeChar();
+            if(isEnd())
+            {
+                throw std::logic_error("Invalid regex: Unexpected end of expression after '|'.");
+            }
+
+            Fragment right = parseTerm();
+            fragment.nullable = fragment.nullable || right.nullable;
+            fragment.first.addSet(right.first);
+            fragment.last.addSet(right.last);
+        }
+
+        return fragment;
+    }
+
+    constexpr Fragment parseTerm()
+    {
+        if(isEnd())
+        {
+            throw std::logic_error("Invalid regex: Unexpected end of expression.");
+        }
+
+        Fragment fragment = parseFactor();
+
+        while(!isEnd() && isInFactorFirstSet(peekChar()))
+        {
+            Fragment right = parseFactor();
+            addFollow(fragment.last, right.first);
+
+            if(fragment.nullable)
+            {
+                fragment.first.addSet(right.first);
+            }
+            if(right.nullable)
+            {
+                right.last.addSet(fragment.last);
+            }
+            fragment.last = right.last;
+            fragment.nullable = fragment.nullable && right.nullable;
+        }
+
+        if(!isEnd() && !isInTermFollowSet(peekChar()))
+        {
+            throw std::logic_error("Invalid regex: Unexpected character after term.");
+        }
+
+        return fragment;
+    }
+
+    constexpr Fragment parseFactor()
+    {
+        if(isEnd())
+        {
+            throw std::logic_error("Invalid regex: Unexpected end of expression.");
+        }
+
+        Fragment fragment = parseAtom();
+
+        char c = peekChar();
+        if(c == '*' || c == '+')
+        {
+            consumeChar();
+            addFollow(fragment.last, fragment.first);
+            fragment.nullable = fragment.nullable || (c == '*');
+        }
+        else if(c == '?')
+        {
+            consumeChar();
+            fragment.nullable = true;
+        }
+
+        return fragment;
+    }
+
+    constexpr Fragment parseAtom()
+    {
+        if(isEnd())
+        {
+            throw std::logic_error("Invalid regex: Unexpected end of expression.");
+        }
+
+        if(peekChar() == '(')
+        {
+            consumeChar();
+            Fragment fragment = parseRegEx();
+
+            if(isEnd())
+            {
+                throw std::logic_error("Invalid regex: Unexpected end of expression after '('.");
+            }
+            if(peekChar() != ')')
+            {
+                throw std::logic_error("Invalid regex: Missing ')' after '('.");
+            }
+
+            consumeChar();
+            return fragment;
+        }
+
+        char c = peekChar();
+        if(c == '\\')
+        {
+            return addPosition(parseEscapedChar());
+        }
+        else if(c == '[')
+        {
+            return addPosition(parseCharSet());
+        }
+        else if(isLiteralChar(c))
+        {
+            consumeChar();
+            CharSet chars;
+            chars.add(static_cast<unsigned char>(c));
+            return addPosition(chars);
+        }
+
+        throw std::logic_error("Invalid regex: Unexpected character.");
+    }
+
+    constexpr CharSet parseEscapedChar()
+    {
+        consumeChar();
+        if(isEnd())
+        {
+            throw std::logic_error("Invalid regex: Unexpected end of expression after '\\'.");
+        }
+
+        char c = peekChar();
+        if(!isEscapedLiteralChar(c))
+        {
+            throw std::logic_error("Invalid regex: Unexpected character after '\\'.");
+        }
+        consumeChar();
+
+        CharSet chars;
+        if(isMetaChar(c))
+        {
+            chars.add(static_cast<unsigned char>(c));
+        }
+        else if(c == 'n')
+        {
+            chars.add('\n');
+        }
+        else if(c == 't')
+        {
+            chars.add('\t');
+        }
+        else if(c == 'r')
+        {
+            chars.add('\r');
+        }
+        else if(c == 's')
+        {
+            chars = whiteSpaceChar();
+        }
+        else if(c == 'd')
+        {
+            chars = digitChar();
+        }
+        else
+        {
+            chars = wordChar();
+        }
+
+        return chars;
+    }
+
+    constexpr CharSet parseCharSet()
+    {
+        consumeChar();
+
+        bool isNegated = false;
+        if(peekChar() == '^')
+        {
+            isNegated = true;
+            consumeChar();
+        }
+
+        if(isEnd() || peekChar() == ']')
+        {
+            throw std::logic_error("Invalid regex: Empty or malformed character set.");
+        }
+
+        CharSet chars;
+        do
+        {
+            parseCharSetItem(chars);
+        } while(!isEnd() && peekChar() != ']');
+
+        if(isEnd())
+        {
+            throw std::logic_error("Invalid regex: Unclosed character set.");
+        }
+        consumeChar();
+
+        if(!isNegated)
+        {
+            return chars;
+        }
+
+        CharSet negated;
+        for(unsigned c = 0; c < DFATable::BYTE_COUNT; c++)
+        {
+            if(isInAlphaBet(static_cast<unsigned char>(c)) && !chars.has(static_cast<unsigned char>(c)))
+            {
+                negated.add(static_cast<unsigned char>(c));
+            }
+        }
+        return negated;
+    }
+
+    constexpr void parseCharSetItem(CharSet &chars)
+    {
+        char c = peekChar();
+        if(isAlphaNumber(c) && peekChar(1) == '-' && !isEnd(2) && isAlphaNumber(peekChar(2)))
+        {
+            parseRange(chars);
+        }
+        else if(c == '\\')
+        {
+            chars.addSet(parseEscapedChar());
+        }
+        else
+        {
+            // inside a set every other character is literal, as in RegExParser
+            consumeChar();
+            chars.add(static_cast<unsigned char>(c));
+        }
+    }
+
+    constexpr void parseRange(CharSet &chars)
+    {
+        char start = peekChar();
+        char end = peekChar(2);
+        index_ += 3;
+
+        if(start > end)
+        {
+            throw std::logic_error("Invalid regex: Invalid range.");
+        }
+
+        if(isDigit(start) && isDigit(end))
+        {
+            for(char c = start; c <= end; c++)
+            {
+                chars.add(static_cast<unsigned char>(c));
+            }
+            return;
+        }
+
+        if(isLetter(start) && isLetter(end))
+        {
+            for(char c = start; c <= end; c++)
+            {
+                if(isLetter(c))
+                {
+                    chars.add(static_cast<unsigned char>(c));
+                }
+            }
+            return;
+        }
+
+        throw std::logic_error("Invalid regex: Invalid range.");
+    }
+
+    constexpr int32_t acceptTagOf(const PositionSet &positions) const
+    {
+        int32_t acceptTag = DFATable::NO_ACCEPT;
+        for(size_t position = 0; position < positionCount_; position++)
+        {
+            int32_t tag = positionAcceptTags_[position];
+            if(positions.has(position) && tag != DFATable::NO_ACCEPT && (acceptTag == DFATable::NO_ACCEPT || tag < acceptTag))
+            {
+                acceptTag = tag;
+            }
+        }
+        return acceptTag;
+    }
+
+    constexpr PositionSet followOf(const PositionSet &positions) const
+    {
+        PositionSet follow;
+        for(size_t position = 0; position < positionCount_; position++)
+        {
+            if(positions.has(position))
+            {
+                follow.addSet(positionFollow_[position]);
+            }
+        }
+        return follow;
+    }
+
+    constexpr DFA buildDFA() const
+    {
+        DFA dfa;
+
+        // bytes are equivalent when the same positions accept them
+        PositionSet classPositions[MaxClasses] = {};
+        for(unsigned c = 0; c < DFATable::BYTE_COUNT; c++)
+        {
+            PositionSet signature;
+            for(size_t position = 0; position < positionCount_; position++)
+            {
+                if(positionChars_[position].has(static_cast<unsigned char>(c)))
+                {
+                    signature.add(position);
+                }
+            }
+
+            size_t byteClass = 0;
+            while(byteClass < dfa.classCount && !classPositions[byteClass].equals(signature))
+            {
+                byteClass++;
+            }
+            if(byteClass == dfa.classCount)
+            {
+                if(dfa.classCount >= MaxClasses)
+                {
+                    throw std::logic_error("StaticRegExCompiler: too many byte classes, raise MaxClasses");
+                }
+                classPositions[dfa.classCount++] = signature;
+            }
+
+            dfa.byteClassMap[c] = static_cast<uint8_t>(byteClass);
+        }
+
+        // state 0 is the start, it has matched no position yet
+        PositionSet statePositions[MaxStates] = {};
+        PositionSet stateFollow[MaxStates] = {};
+        stateFollow[0] = startFollow_;
+        dfa.acceptTags[0] = startAcceptTag_;
+        dfa.stateCount = 1;
+
+        for(size_t state = 0; state < dfa.stateCount; state++)
+        {
+            for(size_t byteClass = 0; byteClass < dfa.classCount; byteClass++)
+            {
+                PositionSet next = stateFollow[state].intersect(classPositions[byteClass]);
+
+                int32_t nextState = DFATable::DEAD_STATE;
+                if(!next.empty())
+                {
+                    size_t found = 1;
+                    while(found < dfa.stateCount && !statePositions[found].equals(next))
+                    {
+                        found++;
+                    }
+
+                    if(found == dfa.stateCount)
+                    {
+                        if(dfa.stateCount >= MaxStates)
+                        {
+                            throw std::logic_error("StaticRegExCompiler: too many states, raise MaxStates");
+                        }
+
+                        statePositions[found] = next;
+                        stateFollow[found] = followOf(next);
+                        dfa.acceptTags[found] = acceptTagOf(next);
+                        dfa.stateCount++;
+                    }
+
+                    nextState = static_cast<int32_t>(found);
+                }
+
+                dfa.transitions[state * dfa.classCount + byteClass] = nextState;
+            }
+        }
+
+        return dfa;
+    }
+
+private:
+    std::string_view pattern_;
+    size_t index_ = 0;
+
+    CharSet positionChars_[MaxPositions] = {};
+    PositionSet positionFollow_[MaxPositions] = {};
+    int32_t positionAcceptTags_[MaxPositions] = {};
+    size_t positionCount_ = 0;
+
+    PositionSet startFollow_;
+    int32_t startAcceptTag_ = DFATable::NO_ACCEPT;
+};
+
+#endif // _STATIC_REGEX_H_
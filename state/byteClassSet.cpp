@@ -0,0 +1,75 @@
+#include "byteClassSet.h"
+
+ByteClassSet::ByteClassSet()
+{
+    classMap_.fill(0);
+    classCount_ = 1;
+}
+
+void ByteClassSet::addChar(char charactar)
+{
+    std::array<bool, BYTE_COUNT> member{};
+    member[static_cast<unsigned char>(charactar)] = true;
+
+    refine(member);
+}
+
+void ByteClassSet::addCharSet(const std::set<char> &charSet)
+{
+    std::array<bool, BYTE_COUNT> member{};
+    for(char charactar : charSet)
+    {
+        member[static_cast<unsigned char>(charactar)] = true;
+    }
+
+    refine(member);
+}
+
+size_t ByteClassSet::getClassCount() const
+{
+    return classCount_;
+}
+
+uint8_t ByteClassSet::getClass(char charactar) const
+{
+    return classMap_[static_cast<unsigned char>(charactar)];
+}
+
+char ByteClassSet::getRepresentative(uint8_t byteClass) const
+{
+    for(size_t byte = 0; byte < BYTE_COUNT; byte++)
+    {
+        if(classMap_[byte] == byteClass)
+        {
+            return static_cast<char>(byte);
+        }
+    }
+
+    return '\0';
+}
+
+const std::array<uint8_t, ByteClassSet::BYTE_COUNT> &ByteClassSet::getClassMap() const
+{
+    return classMap_;
+}
+
+void ByteClassSet::refine(const std::array<bool, BYTE_COUNT> &member)
+{
+    // every (old class, membership) pair becomes a class, numbered by first byte
+    std::array<int, BYTE_COUNT * 2> newClass;
+    newClass.fill(-1);
+
+    size_t classCount = 0;
+    for(size_t byte = 0; byte < BYTE_COUNT; byte++)
+    {
+        size_t key = classMap_[byte] * 2 + (member[byte] ? 1 : 0);
+        if(newClass[key] < 0)
+        {
+            newClass[key] = static_cast<int>(classCount++);
+        }
+
+        classMap_[byte] = static_cast<uint8_t>(newClass[key]);
+    }
+
+    classCount_ = classCount;
+}
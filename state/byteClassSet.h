@@ -0,0 +1,35 @@
+#ifndef _BYTE_CLASS_SET_H_
+#define _BYTE_CLASS_SET_H_
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <set>
+
+// Partition of the 256 byte values into classes that no character set tells apart.
+// Every added set refines the partition, bytes sharing a class behave identically in the DFA.
+class ByteClassSet
+{
+public:
+    static constexpr size_t BYTE_COUNT = 256;
+
+    ByteClassSet();
+    ~ByteClassSet() = default;
+
+    void addChar(char charactar);
+    void addCharSet(const std::set<char> &charSet);
+
+    size_t getClassCount() const;
+    uint8_t getClass(char charactar) const;
+    char getRepresentative(uint8_t byteClass) const;
+    const std::array<uint8_t, BYTE_COUNT> &getClassMap() const;
+
+private:
+    void refine(const std::array<bool, BYTE_COUNT> &member);
+
+private:
+    std::array<uint8_t, BYTE_COUNT> classMap_;
+    size_t classCount_;
+};
+
+#endif // _BYTE_CLASS_SET_H_
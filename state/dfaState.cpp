@@ -1,4 +1,5 @@
 #include "dfaState.h"
+#include <atomic>
 
 DFAState::DFAState(bool isEndState)
 {
@@ -40,7 +41,7 @@ bool DFAState::isEndState() const
 
 int DFAState::genId()
 {
-    static int id = 0;
+    static std::atomic<int> id{0};
 
     return id++;
 }
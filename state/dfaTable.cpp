@@ -0,0 +1,482 @@
+#include "dfaTable.h"
+#include "mappedFile.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+namespace
+{
+    const char DFA_FILE_MAGIC[4] = {'C', 'D', 'F', 'A'};
+    const uint32_t DFA_FILE_VERSION = 1;
+    // reads back differently on a machine of the other byte order
+    const uint32_t DFA_FILE_BYTE_ORDER = 0x01020304;
+
+    struct DfaFileHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t byteOrder;
+        uint32_t classCount;
+        uint32_t stateCount;
+        uint32_t reserved;
+    };
+
+    // keeps the int32 tables after the byte class map 4-byte aligned within the file
+    static_assert(sizeof(DfaFileHeader) % 4 == 0, "header size must keep the tables aligned");
+}
+
+DFATable::DFATable()
+{
+    byteClassMap_.fill(0);
+    classCount_ = 1;
+    stateCount_ = 0;
+    bindStorage();
+}
+
+DFATable::DFATable(const std::array<uint8_t, BYTE_COUNT> &byteClassMap, size_t classCount)
+{
+    byteClassMap_ = byteClassMap;
+    classCount_ = classCount;
+    stateCount_ = 0;
+    bindStorage();
+}
+
+DFATable::DFATable(const DFATable &other)
+    : byteClassMap_(other.byteClassMap_),
+      classCount_(other.classCount_),
+      stateCount_(other.stateCount_),
+      transitions_(other.transitions_),
+      acceptTags_(other.acceptTags_),
+      mappedFile_(other.mappedFile_),
+      transitionData_(other.transitionData_),
+      acceptData_(other.acceptData_)
+{
+    bindStorage();
+}
+
+DFATable::DFATable(DFATable &&other) noexcept
+    : byteClassMap_(other.byteClassMap_),
+      classCount_(other.classCount_),
+      stateCount_(other.stateCount_),
+      transitions_(std::move(other.transitions_)),
+      acceptTags_(std::move(other.acceptTags_)),
+      mappedFile_(std::move(other.mappedFile_)),
+      transitionData_(other.transitionData_),
+      acceptData_(other.acceptData_)
+{
+    bindStorage();
+    other.stateCount_ = 0;
+    other.bindStorage();
+}
+
+DFATable &DFATable::operator=(const DFATable &other)
+{
+    if(this != &other)
+    {
+        byteClassMap_ = other.byteClassMap_;
+        classCount_ = other.classCount_;
+        stateCount_ = other.stateCount_;
+        transitions_ = other.transitions_;
+        acceptTags_ = other.acceptTags_;
+        mappedFile_ = other.mappedFile_;
+        transitionData_ = other.transitionData_;
+        acceptData_ = other.acceptData_;
+        bindStorage();
+    }
+
+    return *this;
+}
+
+DFATable &DFATable::operator=(DFATable &&other) noexcept
+{
+    if(this != &other)
+    {
+        byteClassMap_ = other.byteClassMap_;
+        classCount_ = other.classCount_;
+        stateCount_ = other.stateCount_;
+        transitions_ = std::move(other.transitions_);
+        acceptTags_ = std::move(other.acceptTags_);
+        mappedFile_ = std::move(other.mappedFile_);
+        transitionData_ = other.transitionData_;
+        acceptData_ = other.acceptData_;
+        bindStorage();
+
+        other.transitions_.clear();
+        other.acceptTags_.clear();
+        other.stateCount_ = 0;
+        other.bindStorage();
+    }
+
+    return *this;
+}
+
+void DFATable::bindStorage()
+{
+    // a mapped table keeps pointing into the (shared) mapping
+    if(!mappedFile_)
+    {
+        transitionData_ = transitions_.data();
+        acceptData_ = acceptTags_.data();
+    }
+}
+
+int32_t DFATable::addState(int32_t acceptTag)
+{
+    if(mappedFile_)
+    {
+        throw std::logic_error("DFATable loaded from a file is read-only");
+    }
+
+    int32_t state = static_cast<int32_t>(stateCount_++);
+
+    acceptTags_.push_back(acceptTag);
+    transitions_.resize(transitions_.size() + classCount_, DEAD_STATE);
+    bindStorage();
+
+    return state;
+}
+
+void DFATable::addTransition(int32_t state, uint8_t byteClass, int32_t nextState)
+{
+    if(mappedFile_)
+    {
+        throw std::logic_error("DFATable loaded from a file is read-only");
+    }
+
+    transitions_[static_cast<size_t>(state) * classCount_ + byteClass] = nextState;
+}
+
+int32_t DFATable::getStartState() const
+{
+    return 0;
+}
+
+size_t DFATable::getStateCount() const
+{
+    return stateCount_;
+}
+
+size_t DFATable::getClassCount() const
+{
+    return classCount_;
+}
+
+const std::array<uint8_t, DFATable::BYTE_COUNT> &DFATable::getByteClassMap() const
+{
+    return byteClassMap_;
+}
+
+int32_t DFATable::getTransition(int32_t state, uint8_t byteClass) const
+{
+    return transitionData_[static_cast<size_t>(state) * classCount_ + byteClass];
+}
+
+DFATable DFATable::minimize() const
+{
+    const size_t stateCount = getStateCount();
+    if(stateCount == 0)
+    {
+        return *this;
+    }
+
+    // the missing transitions all lead to an explicit dead state, so the automaton is complete
+    const size_t totalCount = stateCount + 1;
+    const int32_t deadState = static_cast<int32_t>(stateCount);
+
+    auto target = [&](size_t state, size_t input) -> int32_t
+    {
+        if(state == static_cast<size_t>(deadState))
+        {
+            return deadState;
+        }
+
+        int32_t nextState = transitionData_[state * classCount_ + input];
+        return nextState == DEAD_STATE ? deadState : nextState;
+    };
+
+    // inverse transitions in CSR form, indexed by (input, target)
+    std::vector<size_t> inverseOffsets(classCount_ * totalCount + 1, 0);
+    for(size_t state = 0; state < totalCount; state++)
+    {
+        for(size_t input = 0; input < classCount_; input++)
+        {
+            inverseOffsets[input * totalCount + target(state, input) + 1]++;
+        }
+    }
+    for(size_t i = 1; i < inverseOffsets.size(); i++)
+    {
+        inverseOffsets[i] += inverseOffsets[i - 1];
+    }
+
+    std::vector<int32_t> inverseSources(inverseOffsets.back());
+    std::vector<size_t> fill(inverseOffsets.begin(), inverseOffsets.end() - 1);
+    for(size_t state = 0; state < totalCount; state++)
+    {
+        for(size_t input = 0; input < classCount_; input++)
+        {
+            inverseSources[fill[input * totalCount + target(state, input)]++] = static_cast<int32_t>(state);
+        }
+    }
+
+    // partition: each block is a range of `elements`, the marked members are moved to its front
+    std::vector<int32_t> elements(totalCount);
+    std::vector<size_t> location(totalCount);
+    std::vector<size_t> blockOf(totalCount);
+    std::vector<size_t> blockStart;
+    std::vector<size_t> blockEnd;
+    std::vector<size_t> markedEnd;
+    std::vector<bool> inWorkList;
+    std::vector<size_t> workList;
+
+    // the initial blocks group states by accept tag
+    auto acceptTag = [&](int32_t state)
+    {
+        return state == deadState ? NO_ACCEPT : acceptData_[state];
+    };
+
+    for(size_t state = 0; state < totalCount; state++)
+    {
+        elements[state] = static_cast<int32_t>(state);
+    }
+    std::stable_sort(elements.begin(), elements.end(), [&](int32_t a, int32_t b)
+    {
+        return acceptTag(a) < acceptTag(b);
+    });
+
+    for(size_t position = 0; position < totalCount; position++)
+    {
+        int32_t state = elements[position];
+        if(position == 0 || acceptTag(elements[position - 1]) != acceptTag(state))
+        {
+            workList.push_back(blockStart.size());
+            inWorkList.push_back(true);
+            blockStart.push_back(position);
+            blockEnd.push_back(position);
+            markedEnd.push_back(position);
+        }
+
+        location[state] = position;
+        blockOf[state] = blockStart.size() - 1;
+        blockEnd.back() = position + 1;
+    }
+
+    std::vector<size_t> touchedBlocks;
+    std::vector<int32_t> splitter;
+
+    while(!workList.empty())
+    {
+        size_t block = workList.back();
+        workList.pop_back();
+        inWorkList[block] = false;
+
+        splitter.assign(elements.begin() + blockStart[block], elements.begin() + blockEnd[block]);
+
+        for(size_t input = 0; input < classCount_; input++)
+        {
+            for(int32_t state : splitter)
+            {
+                size_t offset = input * totalCount + state;
+                for(size_t i = inverseOffsets[offset]; i < inverseOffsets[offset + 1]; i++)
+                {
+                    int32_t source = inverseSources[i];
+                    size_t sourceBlock = blockOf[source];
+                    size_t sourcePosition = location[source];
+
+                    if(sourcePosition < markedEnd[sourceBlock])
+                    {
+                        continue;
+                    }
+
+                    if(markedEnd[sourceBlock] == blockStart[sourceBlock])
+                    {
+                        touchedBlocks.push_back(sourceBlock);
+                    }
+
+                    size_t swapPosition = markedEnd[sourceBlock]++;
+                    int32_t swapState = elements[swapPosition];
+                    std::swap(elements[swapPosition], elements[sourcePosition]);
+                    location[swapState] = sourcePosition;
+                    location[source] = swapPosition;
+                }
+            }
+
+            for(size_t touched : touchedBlocks)
+            {
+                if(markedEnd[touched] == blockEnd[touched])
+                {
+                    markedEnd[touched] = blockStart[touched];
+                    continue;
+                }
+
+                size_t newBlock = blockStart.size();
+                blockStart.push_back(blockStart[touched]);
+                blockEnd.push_back(markedEnd[touched]);
+                markedEnd.push_back(blockStart[touched]);
+                inWorkList.push_back(false);
+
+                blockStart[touched] = blockEnd[newBlock];
+                markedEnd[touched] = blockStart[touched];
+
+                for(size_t i = blockStart[newBlock]; i < blockEnd[newBlock]; i++)
+                {
+                    blockOf[elements[i]] = newBlock;
+                }
+
+                size_t newSize = blockEnd[newBlock] - blockStart[newBlock];
+                size_t oldSize = blockEnd[touched] - blockStart[touched];
+                if(inWorkList[touched] || newSize <= oldSize)
+                {
+                    workList.push_back(newBlock);
+                    inWorkList[newBlock] = true;
+                }
+                else
+                {
+                    workList.push_back(touched);
+                    inWorkList[touched] = true;
+                }
+            }
+            touchedBlocks.clear();
+        }
+    }
+
+    // number the surviving blocks, the start state's block first, the dead block dropped
+    std::vector<int32_t> blockToState(blockStart.size(), DEAD_STATE);
+    std::vector<int32_t> representatives;
+    DFATable minimized(byteClassMap_, classCount_);
+
+    for(size_t state = 0; state < stateCount; state++)
+    {
+        size_t block = blockOf[state];
+        if(block == blockOf[deadState] || blockToState[block] != DEAD_STATE)
+        {
+            continue;
+        }
+
+        blockToState[block] = minimized.addState(acceptData_[state]);
+        representatives.push_back(static_cast<int32_t>(state));
+    }
+
+    if(representatives.empty())
+    {
+        // the language is empty, keep a lone rejecting start state
+        minimized.addState(NO_ACCEPT);
+    }
+
+    for(size_t newState = 0; newState < representatives.size(); newState++)
+    {
+        size_t state = representatives[newState];
+        for(size_t input = 0; input < classCount_; input++)
+        {
+            int32_t nextState = transitionData_[state * classCount_ + input];
+            if(nextState != DEAD_STATE)
+            {
+                minimized.transitions_[newState * classCount_ + input] = blockToState[blockOf[nextState]];
+            }
+        }
+    }
+
+    return minimized;
+}
+
+void DFATable::save(const std::string &path) const
+{
+    std::ofstream output(path, std::ios::binary | std::ios::trunc);
+    if(!output)
+    {
+        throw std::runtime_error("cannot write DFA file: " + path);
+    }
+
+    DfaFileHeader header = {};
+    std::memcpy(header.magic, DFA_FILE_MAGIC, sizeof(header.magic));
+    header.version = DFA_FILE_VERSION;
+    header.byteOrder = DFA_FILE_BYTE_ORDER;
+    header.classCount = static_cast<uint32_t>(classCount_);
+    header.stateCount = static_cast<uint32_t>(stateCount_);
+
+    output.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    output.write(reinterpret_cast<const char *>(byteClassMap_.data()), BYTE_COUNT);
+    output.write(reinterpret_cast<const char *>(acceptData_), stateCount_ * sizeof(int32_t));
+    output.write(reinterpret_cast<const char *>(transitionData_), stateCount_ * classCount_ * sizeof(int32_t));
+
+    if(!output)
+    {
+        throw std::runtime_error("cannot write DFA file: " + path);
+    }
+}
+
+DFATable DFATable::load(const std::string &path)
+{
+    std::shared_ptr<const MappedFile> file = std::make_shared<MappedFile>(path);
+
+    DfaFileHeader header = {};
+    if(file->size() < sizeof(header) + BYTE_COUNT)
+    {
+        throw std::runtime_error("not a DFA file: " + path);
+    }
+    std::memcpy(&header, file->data(), sizeof(header));
+
+    if(std::memcmp(header.magic, DFA_FILE_MAGIC, sizeof(header.magic)) != 0)
+    {
+        throw std::runtime_error("not a DFA file: " + path);
+    }
+    if(header.version != DFA_FILE_VERSION)
+    {
+        throw std::runtime_error("unsupported DFA file version " + std::to_string(header.version) + ": " + path);
+    }
+    if(header.byteOrder != DFA_FILE_BYTE_ORDER)
+    {
+        throw std::runtime_error("DFA file has the wrong byte order: " + path);
+    }
+    if(header.classCount == 0 || header.classCount > BYTE_COUNT || header.stateCount == 0)
+    {
+        throw std::runtime_error("corrupt DFA file: " + path);
+    }
+
+    const size_t acceptOffset = sizeof(header) + BYTE_COUNT;
+    const size_t transitionOffset = acceptOffset + static_cast<size_t>(header.stateCount) * sizeof(int32_t);
+    const size_t expectedSize = transitionOffset + static_cast<size_t>(header.stateCount) * header.classCount * sizeof(int32_t);
+    if(file->size() != expectedSize)
+    {
+        throw std::runtime_error("corrupt DFA file: " + path);
+    }
+
+    DFATable table;
+    std::memcpy(table.byteClassMap_.data(), file->data() + sizeof(header), BYTE_COUNT);
+    table.classCount_ = header.classCount;
+    table.stateCount_ = header.stateCount;
+
+    // the mapping is page aligned and every offset is a multiple of 4
+    table.acceptData_ = reinterpret_cast<const int32_t *>(file->data() + acceptOffset);
+    table.transitionData_ = reinterpret_cast<const int32_t *>(file->data() + transitionOffset);
+
+    // run() indexes with these unchecked, so a bad entry must not get past loading
+    for(size_t byte = 0; byte < BYTE_COUNT; byte++)
+    {
+        if(table.byteClassMap_[byte] >= table.classCount_)
+        {
+            throw std::runtime_error("corrupt DFA file: " + path);
+        }
+    }
+    for(size_t state = 0; state < table.stateCount_; state++)
+    {
+        if(table.acceptData_[state] < NO_ACCEPT)
+        {
+            throw std::runtime_error("corrupt DFA file: " + path);
+        }
+    }
+    const size_t transitionCount = table.stateCount_ * table.classCount_;
+    for(size_t i = 0; i < transitionCount; i++)
+    {
+        const int32_t nextState = table.transitionData_[i];
+        if(nextState != DEAD_STATE && (nextState < 0 || static_cast<size_t>(nextState) >= table.stateCount_))
+        {
+            throw std::runtime_error("corrupt DFA file: " + path);
+        }
+    }
+
+    table.mappedFile_ = std::move(file);
+
+    return table;
+}
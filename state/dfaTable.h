@@ -0,0 +1,86 @@
+#ifndef _DFA_TABLE_H_
+#define _DFA_TABLE_H_
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+class MappedFile;
+
+// Dense transition table: row per state, column per byte class.
+// State ids are small integers, DEAD_STATE marks a missing transition.
+// Every state carries an accept tag (the id of the pattern it accepts) or NO_ACCEPT.
+// A table is either built in memory or loaded from a saved file, which is mapped and read in place.
+class DFATable
+{
+public:
+    static constexpr int32_t DEAD_STATE = -1;
+    static constexpr int32_t NO_ACCEPT = -1;
+    static constexpr size_t BYTE_COUNT = 256;
+
+    DFATable();
+    DFATable(const std::array<uint8_t, BYTE_COUNT> &byteClassMap, size_t classCount);
+    ~DFATable() = default;
+
+    DFATable(const DFATable &other);
+    DFATable(DFATable &&other) noexcept;
+    DFATable& operator=(const DFATable &other);
+    DFATable& operator=(DFATable &&other) noexcept;
+
+    int32_t addState(int32_t acceptTag);
+    void addTransition(int32_t state, uint8_t byteClass, int32_t nextState);
+
+    int32_t run(int32_t state, char input) const
+    {
+        return transitionData_[static_cast<size_t>(state) * classCount_ + byteClassMap_[static_cast<unsigned char>(input)]];
+    }
+
+    bool isEndState(int32_t state) const
+    {
+        return acceptData_[state] != NO_ACCEPT;
+    }
+
+    int32_t getAcceptTag(int32_t state) const
+    {
+        return acceptData_[state];
+    }
+
+    int32_t getStartState() const;
+    size_t getStateCount() const;
+    size_t getClassCount() const;
+
+    const std::array<uint8_t, BYTE_COUNT> &getByteClassMap() const;
+    int32_t getTransition(int32_t state, uint8_t byteClass) const;
+
+    // Hopcroft partition refinement, returns the equivalent minimal table.
+    DFATable minimize() const;
+
+    // versioned native-endian image: header, byte class map, accept tags, transitions
+    void save(const std::string &path) const;
+    // maps the file and reads the tables in place. The header, the size and every byte class,
+    // accept tag and transition are checked first, so loading is O(table size), not just a map.
+    // the result is read-only, addState/addTransition throw
+    static DFATable load(const std::string &path);
+
+private:
+    void bindStorage();
+
+private:
+    std::array<uint8_t, BYTE_COUNT> byteClassMap_;
+    size_t classCount_;
+    size_t stateCount_;
+
+    // owned tables, empty when the table is loaded from a file
+    std::vector<int32_t> transitions_;
+    std::vector<int32_t> acceptTags_;
+    std::shared_ptr<const MappedFile> mappedFile_;
+
+    // what run() reads: the vectors above or the mapping
+    const int32_t *transitionData_;
+    const int32_t *acceptData_;
+};
+
+#endif // _DFA_TABLE_H_
@@ -0,0 +1,289 @@
+#include "lazyDfa.h"
+#include "alphaBet.h"
+#include <algorithm>
+
+LazyDFA::LazyDFA(const NFA &nfa, int32_t nfaStartState, const ByteClassSet &byteClassSet, size_t cacheBudget)
+{
+    byteClassMap_ = byteClassSet.getClassMap();
+    classCount_ = byteClassSet.getClassCount();
+
+    const size_t nfaStateCount = nfa.getStateCount();
+
+    moves_.resize(nfaStateCount);
+    epsilons_.resize(nfaStateCount);
+    nfaAcceptTags_.resize(nfaStateCount);
+    for(size_t state = 0; state < nfaStateCount; state++)
+    {
+        nfaAcceptTags_[state] = nfa.getState(static_cast<int32_t>(state)).getAcceptTag();
+
+        epsilons_[state] = nfa.getState(static_cast<int32_t>(state)).getEpsilonTransitions();
+
+        auto &stateMoves = moves_[state];
+        for(const auto &transition : nfa.getState(static_cast<int32_t>(state)).getTransitions())
+        {
+            // bytes outside the alphabet never transition
+            if(AlphaBet::instance().isInAlphaBet(transition.first))
+            {
+                stateMoves.emplace_back(byteClassSet.getClass(transition.first), transition.second);
+            }
+        }
+
+        std::sort(stateMoves.begin(), stateMoves.end());
+        stateMoves.erase(std::unique(stateMoves.begin(), stateMoves.end()), stateMoves.end());
+    }
+
+    nfaStartState_ = nfaStartState;
+
+    cacheBudget_ = cacheBudget;
+    cacheMemory_ = 0;
+    flushCount_ = 0;
+
+    nextStateSets_.resize(classCount_);
+
+    closureMarks_.resize(nfaStateCount, 0);
+    closureMark_ = 0;
+
+    // the compact NFA copy and the closure marks, transitions and epsilon edges are stored once
+    nfaMemory_ = 0;
+    for(size_t state = 0; state < nfaStateCount; state++)
+    {
+        nfaMemory_ += moves_[state].size() * sizeof(std::pair<uint8_t, int32_t>) + epsilons_[state].size() * sizeof(int32_t);
+    }
+    nfaMemory_ += nfaStateCount * (2 * sizeof(std::vector<int32_t>) + sizeof(int32_t) + sizeof(uint32_t));
+
+    epsilonClosure(NfaStateSet{ nfaStartState_ }, closure_);
+    addState(closure_);
+}
+
+std::optional<size_t> LazyDFA::match(const char *data, size_t size)
+{
+    int32_t currentState = 0;
+    std::optional<size_t> matchedIndex = std::nullopt;
+
+    if(acceptTags_[currentState] != DFATable::NO_ACCEPT)
+    {
+        matchedIndex = 0;
+    }
+
+    for(size_t index = 0; index < size; index++)
+    {
+        currentState = run(currentState, data[index]);
+
+        if(currentState == DFATable::DEAD_STATE)
+        {
+            break;
+        }
+
+        if(acceptTags_[currentState] != DFATable::NO_ACCEPT)
+        {
+            matchedIndex = index + 1;
+        }
+    }
+
+    return matchedIndex;
+}
+
+std::optional<DFATable> LazyDFA::toDFATable(size_t maxStateCount)
+{
+    // checked before every expansion, so an NFA that alone is over the budget gives up right away
+    for(size_t state = 0; state < stateSets_.size(); state++)
+    {
+        if(isOverBudget(maxStateCount))
+        {
+            return std::nullopt;
+        }
+
+        if(transitions_[state * classCount_] == UNKNOWN_STATE)
+        {
+            expandState(static_cast<int32_t>(state));
+        }
+    }
+
+    if(isOverBudget(maxStateCount))
+    {
+        return std::nullopt;
+    }
+
+    DFATable dfaTable(byteClassMap_, classCount_);
+    for(size_t state = 0; state < stateSets_.size(); state++)
+    {
+        dfaTable.addState(acceptTags_[state]);
+    }
+
+    for(size_t state = 0; state < stateSets_.size(); state++)
+    {
+        for(size_t byteClass = 0; byteClass < classCount_; byteClass++)
+        {
+            dfaTable.addTransition(static_cast<int32_t>(state), static_cast<uint8_t>(byteClass), transitions_[state * classCount_ + byteClass]);
+        }
+    }
+
+    return dfaTable;
+}
+
+int32_t LazyDFA::getAcceptTag(int32_t state) const
+{
+    return acceptTags_[state];
+}
+
+size_t LazyDFA::getStateCount() const
+{
+    return stateSets_.size();
+}
+
+size_t LazyDFA::getCacheMemory() const
+{
+    return cacheMemory_;
+}
+
+size_t LazyDFA::getFlushCount() const
+{
+    return flushCount_;
+}
+
+bool LazyDFA::isOverBudget(size_t maxStateCount) const
+{
+    return stateSets_.size() > maxStateCount || nfaMemory_ + cacheMemory_ > cacheBudget_;
+}
+
+int32_t LazyDFA::run(int32_t state, char input)
+{
+    const uint8_t byteClass = byteClassMap_[static_cast<unsigned char>(input)];
+    int32_t nextState = transitions_[static_cast<size_t>(state) * classCount_ + byteClass];
+    if(nextState != UNKNOWN_STATE)
+    {
+        return nextState;
+    }
+
+    if(cacheMemory_ > cacheBudget_)
+    {
+        // keep only the set we are standing on, everything else is rebuilt when reached again
+        NfaStateSet currentStates = stateSets_[state];
+        flush();
+        state = addState(currentStates);
+    }
+
+    expandState(state);
+
+    return transitions_[static_cast<size_t>(state) * classCount_ + byteClass];
+}
+
+int32_t LazyDFA::addState(const NfaStateSet &states)
+{
+    auto it = stateMap_.find(states);
+    if(it != stateMap_.end())
+    {
+        return it->second;
+    }
+
+    int32_t state = static_cast<int32_t>(stateSets_.size());
+
+    stateMap_.emplace(states, state);
+    stateSets_.push_back(states);
+    transitions_.resize(transitions_.size() + classCount_, UNKNOWN_STATE);
+    int32_t acceptTag = DFATable::NO_ACCEPT;
+    for(int32_t nfaState : states)
+    {
+        int32_t nfaAcceptTag = nfaAcceptTags_[nfaState];
+        if(nfaAcceptTag != NFAState::NO_ACCEPT && (acceptTag == DFATable::NO_ACCEPT || nfaAcceptTag < acceptTag))
+        {
+            acceptTag = nfaAcceptTag;
+        }
+    }
+    acceptTags_.push_back(acceptTag);
+
+    // the set is stored twice (map key and by id), plus a table row and some container overhead
+    cacheMemory_ += 2 * states.size() * sizeof(int32_t) + classCount_ * sizeof(int32_t) + 64;
+
+    return state;
+}
+
+void LazyDFA::expandState(int32_t state)
+{
+    for(int32_t nfaState : stateSets_[state])
+    {
+        for(const auto &move : moves_[nfaState])
+        {
+            NfaStateSet &nextStates = nextStateSets_[move.first];
+            if(nextStates.empty())
+            {
+                touchedClasses_.push_back(move.first);
+            }
+
+            nextStates.push_back(move.second);
+        }
+    }
+
+    std::fill(transitions_.begin() + static_cast<size_t>(state) * classCount_,
+              transitions_.begin() + static_cast<size_t>(state + 1) * classCount_,
+              DFATable::DEAD_STATE);
+
+    for(uint8_t byteClass : touchedClasses_)
+    {
+        NfaStateSet &nextStates = nextStateSets_[byteClass];
+        epsilonClosure(nextStates, closure_);
+
+        int32_t nextState = addState(closure_);
+        transitions_[static_cast<size_t>(state) * classCount_ + byteClass] = nextState;
+
+        nextStates.clear();
+    }
+    touchedClasses_.clear();
+}
+
+void LazyDFA::flush()
+{
+    stateMap_.clear();
+    stateSets_.clear();
+    transitions_.clear();
+    acceptTags_.clear();
+    cacheMemory_ = 0;
+    flushCount_++;
+
+    // the start state always keeps id 0
+    epsilonClosure(NfaStateSet{ nfaStartState_ }, closure_);
+    addState(closure_);
+}
+
+void LazyDFA::epsilonClosure(const NfaStateSet &targets, NfaStateSet &closure)
+{
+    closure.clear();
+
+    closureMark_++;
+    if(closureMark_ == 0)
+    {
+        // the marks wrapped around, old ones could look current again
+        std::fill(closureMarks_.begin(), closureMarks_.end(), 0);
+        closureMark_ = 1;
+    }
+
+    for(int32_t target : targets)
+    {
+        if(closureMarks_[target] == closureMark_)
+        {
+            continue;
+        }
+
+        closureMarks_[target] = closureMark_;
+        closureStack_.push_back(target);
+
+        while(!closureStack_.empty())
+        {
+            int32_t nfaState = closureStack_.back();
+            closureStack_.pop_back();
+            closure.push_back(nfaState);
+
+            for(int32_t nextState : epsilons_[nfaState])
+            {
+                if(closureMarks_[nextState] != closureMark_)
+                {
+                    closureMarks_[nextState] = closureMark_;
+                    closureStack_.push_back(nextState);
+                }
+            }
+        }
+    }
+
+    // sets are looked up by value, so they must be in one canonical order
+    std::sort(closure.begin(), closure.end());
+}
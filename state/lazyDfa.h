@@ -0,0 +1,78 @@
+#ifndef _LAZY_DFA_H_
+#define _LAZY_DFA_H_
+
+#include <array>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+#include "nfa.h"
+#include "byteClassSet.h"
+#include "dfaTable.h"
+
+// Subset construction over a compact copy of an NFA.
+// A DFA state accepts the smallest accept tag among its NFA states, so lower tags win ties.
+// States are created the first time a transition reaches them and cached in a table,
+// once the cache grows past its memory budget it is flushed and rebuilt on demand.
+class LazyDFA
+{
+public:
+    static constexpr int32_t UNKNOWN_STATE = -2;
+    static constexpr size_t UNLIMITED_BUDGET = static_cast<size_t>(-1);
+
+    LazyDFA(const NFA &nfa, int32_t nfaStartState, const ByteClassSet &byteClassSet, size_t cacheBudget = UNLIMITED_BUDGET);
+    ~LazyDFA() = default;
+
+    //NOTICE: Longest Prefix Match, fills the cache as it goes
+    std::optional<size_t> match(const char *data, size_t size);
+    int32_t getAcceptTag(int32_t state) const;
+
+    // expands every reachable state, the result is not minimized;
+    // gives up once more than maxStateCount states or the cache budget would be needed,
+    // the NFA copy and the closure marks count against that budget as well
+    std::optional<DFATable> toDFATable(size_t maxStateCount = UNLIMITED_BUDGET);
+
+    size_t getStateCount() const;
+    size_t getCacheMemory() const;
+    size_t getFlushCount() const;
+
+private:
+    bool isOverBudget(size_t maxStateCount) const;
+    int32_t run(int32_t state, char input);
+    int32_t addState(const NfaStateSet &states);
+    void expandState(int32_t state);
+    void flush();
+
+    // sorted epsilon closure of the NFA states in targets, each state is walked at most once
+    void epsilonClosure(const NfaStateSet &targets, NfaStateSet &closure);
+
+private:
+    std::array<uint8_t, ByteClassSet::BYTE_COUNT> byteClassMap_;
+    size_t classCount_;
+
+    std::vector<std::vector<std::pair<uint8_t, int32_t>>> moves_;
+    std::vector<std::vector<int32_t>> epsilons_;
+    std::vector<int32_t> nfaAcceptTags_;
+    int32_t nfaStartState_;
+
+    std::unordered_map<NfaStateSet, int32_t, NfaStateSetHash> stateMap_;
+    std::vector<NfaStateSet> stateSets_;
+    std::vector<int32_t> transitions_;
+    std::vector<int32_t> acceptTags_;
+
+    size_t cacheBudget_;
+    size_t cacheMemory_;
+    size_t nfaMemory_;
+    size_t flushCount_;
+
+    // move targets per byte class while a state is expanded
+    std::vector<NfaStateSet> nextStateSets_;
+    std::vector<uint8_t> touchedClasses_;
+
+    // an NFA state is in the closure being built when its mark equals closureMark_
+    std::vector<uint32_t> closureMarks_;
+    uint32_t closureMark_;
+    std::vector<int32_t> closureStack_;
+    NfaStateSet closure_;
+};
+
+#endif // _LAZY_DFA_H_
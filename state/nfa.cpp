@@ -0,0 +1,22 @@
+#include "nfa.h"
+
+int32_t NFA::addState()
+{
+    states_.emplace_back();
+    return static_cast<int32_t>(states_.size() - 1);
+}
+
+NFAState &NFA::getState(int32_t state)
+{
+    return states_[state];
+}
+
+const NFAState &NFA::getState(int32_t state) const
+{
+    return states_[state];
+}
+
+size_t NFA::getStateCount() const
+{
+    return states_.size();
+}
@@ -0,0 +1,24 @@
+#ifndef _NFA_H_
+#define _NFA_H_
+
+#include "nfaState.h"
+#include <vector>
+
+// Contiguous arena owning every state of one NFA, state ids are indices.
+class NFA
+{
+public:
+    NFA() = default;
+    ~NFA() = default;
+
+    int32_t addState();
+
+    NFAState& getState(int32_t state);
+    const NFAState& getState(int32_t state) const;
+    size_t getStateCount() const;
+
+private:
+    std::vector<NFAState> states_;
+};
+
+#endif // _NFA_H_
@@ -1,48 +1,31 @@
 #include "nfaState.h"
 
-NFAState::NFAState()
+void NFAState::addTransition(char input, int32_t nextState)
 {
-    id_ = genId();
+    transitions_.emplace_back(input, nextState);
 }
 
-void NFAState::addTransition(char input, std::shared_ptr<NFAState> nextState)
+void NFAState::addEpsilonTransition(int32_t nextState)
 {
-    transitions_[input].insert(nextState);
+    epsilonTransitions_.push_back(nextState);
 }
 
-void NFAState::addEpsilonTransition(std::shared_ptr<NFAState> nextState)
+const std::vector<std::pair<char, int32_t>> &NFAState::getTransitions() const
 {
-    epsilonTransitions_.insert(nextState);
+    return transitions_;
 }
 
-const std::set<std::weak_ptr<NFAState>, CompareWeakNfaStatePtr> &NFAState::getEpsilonTransitions() const
+const std::vector<int32_t> &NFAState::getEpsilonTransitions() const
 {
     return epsilonTransitions_;
 }
 
-std::set<std::shared_ptr<NFAState>, CompareNfaStateSharedPtr> NFAState::run(char input) const
+void NFAState::setAcceptTag(int32_t acceptTag)
 {
-    auto it = transitions_.find(input);
-    if (it == transitions_.end())
-    {
-        return {};
-    }
-    
-    std::set<std::shared_ptr<NFAState>, CompareNfaStateSharedPtr> result;
-    for (auto &state : it->second)
-    {
-        if (auto lockedState = state.lock())
-        {
-            result.insert(lockedState);
-        }
-    }
-
-    return result;
+    acceptTag_ = acceptTag;
 }
 
-int NFAState::genId()
+int32_t NFAState::getAcceptTag() const
 {
-    static int id = 1000;
-
-    return id++;
+    return acceptTag_;
 }
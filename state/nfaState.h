@@ -1,50 +1,49 @@
 #ifndef _NFA_STATE_H_
 #define _NFA_STATE_H_
 
-#include <memory>
-#include <unordered_map>
-#include <string>
-#include <set>
+#include <utility>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
 
-class NFAState;
+// sorted dense NFA state ids
+using NfaStateSet = std::vector<int32_t>;
 
-struct CompareWeakNfaStatePtr
+struct NfaStateSetHash
 {
-    bool operator()(const std::weak_ptr<NFAState> &a, const std::weak_ptr<NFAState> &b) const
+    size_t operator()(const NfaStateSet &states) const
     {
-        return a.owner_before(b);
+        size_t hash = states.size();
+        for (int32_t state : states)
+        {
+            hash ^= static_cast<size_t>(state) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        }
+        return hash;
     }
 };
 
-struct CompareNfaStateSharedPtr
-{
-    bool operator()(const std::shared_ptr<NFAState> &a, const std::shared_ptr<NFAState> &b) const
-    {
-        return a.owner_before(b);
-    }
-};
-
-
+// A state of an NFA arena, edges refer to other states by id.
+// Accepting states carry the id of the pattern they accept.
 class NFAState
 {
 public:
-    NFAState();
+    static constexpr int32_t NO_ACCEPT = -1;
 
-    void addTransition(char input, std::shared_ptr<NFAState> nextState);
+    NFAState() = default;
 
-    void addEpsilonTransition(std::shared_ptr<NFAState> nextState);
-    const std::set<std::weak_ptr<NFAState>, CompareWeakNfaStatePtr>& getEpsilonTransitions() const;
+    void addTransition(char input, int32_t nextState);
+    void addEpsilonTransition(int32_t nextState);
 
-    std::set<std::shared_ptr<NFAState>, CompareNfaStateSharedPtr> run(char input) const;
+    const std::vector<std::pair<char, int32_t>>& getTransitions() const;
+    const std::vector<int32_t>& getEpsilonTransitions() const;
 
-private:
-    static int genId();
+    void setAcceptTag(int32_t acceptTag);
+    int32_t getAcceptTag() const;
 
 private:
-    std::unordered_map<char, std::set<std::weak_ptr<NFAState>, CompareWeakNfaStatePtr>> transitions_;
-    std::set<std::weak_ptr<NFAState>, CompareWeakNfaStatePtr> epsilonTransitions_;
-
-    int id_;
+    std::vector<std::pair<char, int32_t>> transitions_;
+    std::vector<int32_t> epsilonTransitions_;
+    int32_t acceptTag_ = NO_ACCEPT;
 };
 
-#endif // _NFA_STATE_H_
\ No newline at end of file
+#endif // _NFA_STATE_H_
@@ -1,6 +1,6 @@
 #include "nfaStateFragment.h"
 
-NfaStateFragment::NfaStateFragment(std::shared_ptr<NFAState> startState, std::shared_ptr<NFAState> endState)
+NfaStateFragment::NfaStateFragment(int32_t startState, int32_t endState)
 {
     startState_ = startState;
     endState_ = endState;
@@ -10,29 +10,12 @@ NfaStateFragment::~NfaStateFragment()
 {
 }
 
-std::shared_ptr<NFAState> NfaStateFragment::getStartState() const
+int32_t NfaStateFragment::getStartState() const
 {
     return startState_;
 }
 
-std::shared_ptr<NFAState> NfaStateFragment::getEndState() const
+int32_t NfaStateFragment::getEndState() const
 {
     return endState_;
 }
-
-void NfaStateFragment::addState(std::shared_ptr<NFAState> state)
-{
-    if(state)
-    {
-        states_.push_back(state);
-    }
-}
-
-void NfaStateFragment::merge(std::shared_ptr<NfaStateFragment> otherFragment)
-{
-    if(otherFragment)
-    {
-        states_.insert(states_.end(), otherFragment->states_.begin(), otherFragment->states_.end());
-    }
-}
-
@@ -1,25 +1,21 @@
 #ifndef _NFA_STATE_FRAGMENT_H_
 #define _NFA_STATE_FRAGMENT_H_
 
-#include "nfaState.h"
+#include "nfa.h"
 
+// Entry and exit state ids of a sub-automaton inside an NFA arena.
 class NfaStateFragment
 {
 public:
-    NfaStateFragment(std::shared_ptr<NFAState> startState, std::shared_ptr<NFAState> endState);
+    NfaStateFragment(int32_t startState, int32_t endState);
     ~NfaStateFragment();
 
-    std::shared_ptr<NFAState> getStartState() const;
-    std::shared_ptr<NFAState> getEndState() const;
-
-    void addState(std::shared_ptr<NFAState> state);
-    void merge(std::shared_ptr<NfaStateFragment> otherFragment);
+    int32_t getStartState() const;
+    int32_t getEndState() const;
 
 private:
-    std::shared_ptr<NFAState> startState_;
-    std::shared_ptr<NFAState> endState_;
-
-    std::vector<std::shared_ptr<NFAState>> states_;
+    int32_t startState_;
+    int32_t endState_;
 };
 
-#endif // _NFA_STATE_FRAGMENT_H_
\ No newline at end of file
+#endif // _NFA_STATE_FRAGMENT_H_
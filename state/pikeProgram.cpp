@@ -0,0 +1,70 @@
+#include "pikeProgram.h"
+#include "alphaBet.h"
+
+int32_t PikeProgram::emitChar(char charactar)
+{
+    // bytes outside the alphabet never match
+    if(!AlphaBet::instance().isInAlphaBet(charactar))
+    {
+        return emitCharSet({});
+    }
+
+    return emit(PikeOpCode::CHAR, static_cast<unsigned char>(charactar), 0);
+}
+
+int32_t PikeProgram::emitCharSet(const std::set<char> &charSet)
+{
+    CharBitmap bitmap{};
+    for(char charactar : charSet)
+    {
+        if(AlphaBet::instance().isInAlphaBet(charactar))
+        {
+            unsigned char byte = static_cast<unsigned char>(charactar);
+            bitmap[byte >> 6] |= uint64_t(1) << (byte & 63);
+        }
+    }
+
+    charSets_.push_back(bitmap);
+    return emit(PikeOpCode::CHAR_SET, static_cast<int32_t>(charSets_.size() - 1), 0);
+}
+
+int32_t PikeProgram::emitSplit(int32_t x, int32_t y)
+{
+    return emit(PikeOpCode::SPLIT, x, y);
+}
+
+int32_t PikeProgram::emitJump(int32_t x)
+{
+    return emit(PikeOpCode::JUMP, x, 0);
+}
+
+int32_t PikeProgram::emitMatch()
+{
+    return emit(PikeOpCode::MATCH, 0, 0);
+}
+
+int32_t PikeProgram::getNextPc() const
+{
+    return static_cast<int32_t>(instructions_.size());
+}
+
+void PikeProgram::patchX(int32_t pc, int32_t x)
+{
+    instructions_[pc].x = x;
+}
+
+void PikeProgram::patchY(int32_t pc, int32_t y)
+{
+    instructions_[pc].y = y;
+}
+
+const std::vector<PikeInstruction> &PikeProgram::getInstructions() const
+{
+    return instructions_;
+}
+
+int32_t PikeProgram::emit(PikeOpCode opCode, int32_t x, int32_t y)
+{
+    instructions_.push_back(PikeInstruction{opCode, x, y});
+    return static_cast<int32_t>(instructions_.size() - 1);
+}
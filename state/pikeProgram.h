@@ -0,0 +1,61 @@
+#ifndef _PIKE_PROGRAM_H_
+#define _PIKE_PROGRAM_H_
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <set>
+#include <vector>
+
+enum class PikeOpCode : uint8_t
+{
+    CHAR,       // consume one byte equal to x
+    CHAR_SET,   // consume one byte contained in char set x
+    SPLIT,      // continue at both x and y
+    JUMP,       // continue at x
+    MATCH,
+};
+
+struct PikeInstruction
+{
+    PikeOpCode opCode;
+    int32_t x;
+    int32_t y;
+};
+
+// Flat Thompson program, emitted by the RegExNode tree.
+class PikeProgram
+{
+public:
+    using CharBitmap = std::array<uint64_t, 4>;
+
+    PikeProgram() = default;
+    ~PikeProgram() = default;
+
+    int32_t emitChar(char charactar);
+    int32_t emitCharSet(const std::set<char> &charSet);
+    int32_t emitSplit(int32_t x = 0, int32_t y = 0);
+    int32_t emitJump(int32_t x = 0);
+    int32_t emitMatch();
+
+    // program counter of the next emitted instruction
+    int32_t getNextPc() const;
+    void patchX(int32_t pc, int32_t x);
+    void patchY(int32_t pc, int32_t y);
+
+    const std::vector<PikeInstruction>& getInstructions() const;
+    bool isInCharSet(int32_t charSet, char charactar) const
+    {
+        unsigned char byte = static_cast<unsigned char>(charactar);
+        return (charSets_[charSet][byte >> 6] >> (byte & 63)) & 1;
+    }
+
+private:
+    int32_t emit(PikeOpCode opCode, int32_t x, int32_t y);
+
+private:
+    std::vector<PikeInstruction> instructions_;
+    std::vector<CharBitmap> charSets_;
+};
+
+#endif // _PIKE_PROGRAM_H_
@@ -0,0 +1,98 @@
+#include "pikeVm.h"
+#include <utility>
+
+PikeVM::PikeVM(PikeProgram program)
+    : program_(std::move(program))
+{
+}
+
+std::optional<size_t> PikeVM::match(const char *data, size_t size) const
+{
+    const std::vector<PikeInstruction> &instructions = program_.getInstructions();
+
+    ThreadList currentThreads(instructions.size());
+    ThreadList nextThreads(instructions.size());
+    std::vector<int32_t> stack;
+
+    std::optional<size_t> matchedIndex = std::nullopt;
+
+    addThread(currentThreads, 0, stack);
+
+    for(size_t index = 0; ; index++)
+    {
+        for(size_t i = 0; i < currentThreads.size; i++)
+        {
+            if(instructions[currentThreads.dense[i]].opCode == PikeOpCode::MATCH)
+            {
+                matchedIndex = index;
+                break;
+            }
+        }
+
+        if(currentThreads.size == 0 || index == size)
+        {
+            break;
+        }
+
+        const char charactar = data[index];
+        for(size_t i = 0; i < currentThreads.size; i++)
+        {
+            int32_t pc = currentThreads.dense[i];
+            const PikeInstruction &instruction = instructions[pc];
+
+            bool isMatched = false;
+            if(instruction.opCode == PikeOpCode::CHAR)
+            {
+                isMatched = static_cast<unsigned char>(charactar) == instruction.x;
+            }
+            else if(instruction.opCode == PikeOpCode::CHAR_SET)
+            {
+                isMatched = program_.isInCharSet(instruction.x, charactar);
+            }
+
+            if(isMatched)
+            {
+                addThread(nextThreads, pc + 1, stack);
+            }
+        }
+
+        std::swap(currentThreads, nextThreads);
+        nextThreads.size = 0;
+    }
+
+    return matchedIndex;
+}
+
+size_t PikeVM::getInstructionCount() const
+{
+    return program_.getInstructions().size();
+}
+
+void PikeVM::addThread(ThreadList &threadList, int32_t pc, std::vector<int32_t> &stack) const
+{
+    const std::vector<PikeInstruction> &instructions = program_.getInstructions();
+
+    stack.push_back(pc);
+    while(!stack.empty())
+    {
+        int32_t currentPc = stack.back();
+        stack.pop_back();
+
+        if(threadList.contains(currentPc))
+        {
+            continue;
+        }
+        threadList.insert(currentPc);
+
+        const PikeInstruction &instruction = instructions[currentPc];
+        if(instruction.opCode == PikeOpCode::JUMP)
+        {
+            stack.push_back(instruction.x);
+        }
+        else if(instruction.opCode == PikeOpCode::SPLIT)
+        {
+            stack.push_back(instruction.y);
+            stack.push_back(instruction.x);
+        }
+    }
+}
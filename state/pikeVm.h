@@ -0,0 +1,49 @@
+#ifndef _PIKE_VM_H_
+#define _PIKE_VM_H_
+
+#include <optional>
+#include "pikeProgram.h"
+
+// Thompson/Pike simulation of a PikeProgram: every thread advances in lock step,
+// so matching is linear in the input and memory is bounded by the program size.
+class PikeVM
+{
+public:
+    explicit PikeVM(PikeProgram program);
+    ~PikeVM() = default;
+
+    //NOTICE: Longest Prefix Match
+    std::optional<size_t> match(const char *data, size_t size) const;
+
+    size_t getInstructionCount() const;
+
+private:
+    // sparse set of program counters
+    struct ThreadList
+    {
+        std::vector<int32_t> dense;
+        std::vector<int32_t> sparse;
+        size_t size = 0;
+
+        explicit ThreadList(size_t capacity) : dense(capacity), sparse(capacity), size(0) {}
+
+        bool contains(int32_t pc) const
+        {
+            int32_t index = sparse[pc];
+            return index >= 0 && static_cast<size_t>(index) < size && dense[index] == pc;
+        }
+
+        void insert(int32_t pc)
+        {
+            sparse[pc] = static_cast<int32_t>(size);
+            dense[size++] = pc;
+        }
+    };
+
+    void addThread(ThreadList &threadList, int32_t pc, std::vector<int32_t> &stack) const;
+
+private:
+    PikeProgram program_;
+};
+
+#endif // _PIKE_VM_H_
@@ -0,0 +1,203 @@
+#include "shengDfa.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define SHENG_SSSE3
+#include <tmmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define SHENG_TARGET_SSSE3
+#else
+#define SHENG_TARGET_SSSE3 __attribute__((target("ssse3")))
+#endif
+#endif
+
+#ifdef SHENG_SSSE3
+// SSE2 is the x64 baseline, SSSE3 (pshufb) is not, so ask the CPU once
+static bool hasSsse3()
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 9)) != 0;
+#else
+    return __builtin_cpu_supports("ssse3");
+#endif
+}
+#endif
+
+std::unique_ptr<ShengDFA> ShengDFA::fromDFATable(const DFATable &table)
+{
+    const size_t stateCount = table.getStateCount();
+    if(stateCount == 0 || stateCount >= MAX_STATES)
+    {
+        return nullptr;
+    }
+
+    std::unique_ptr<ShengDFA> sheng(new ShengDFA());
+    sheng->stateCount_ = stateCount;
+    sheng->startState_ = static_cast<uint8_t>(table.getStartState());
+    sheng->deadState_ = static_cast<uint8_t>(stateCount);
+    sheng->accelerator_ = StateAccelerator(table);
+
+    for(size_t state = 0; state < stateCount; state++)
+    {
+        if(table.isEndState(static_cast<int32_t>(state)))
+        {
+            sheng->acceptMask_ |= 1u << state;
+        }
+    }
+
+    // unused slots and the dead state itself stay dead
+    sheng->byteRows_.resize(DFATable::BYTE_COUNT);
+    for(size_t byte = 0; byte < DFATable::BYTE_COUNT; byte++)
+    {
+        std::array<uint8_t, MAX_STATES> &row = sheng->byteRows_[byte];
+        row.fill(sheng->deadState_);
+
+        for(size_t state = 0; state < stateCount; state++)
+        {
+            int32_t nextState = table.run(static_cast<int32_t>(state), static_cast<char>(byte));
+            if(nextState != DFATable::DEAD_STATE)
+            {
+                row[state] = static_cast<uint8_t>(nextState);
+            }
+        }
+    }
+
+    return sheng;
+}
+
+std::optional<size_t> ShengDFA::match(const char *data, size_t size) const
+{
+#ifdef SHENG_SSSE3
+    static const bool useSsse3 = hasSsse3();
+    if(useSsse3)
+    {
+        return matchSsse3(data, size);
+    }
+#endif
+
+    return matchScalar(data, size);
+}
+
+size_t ShengDFA::getStateCount() const
+{
+    return stateCount_;
+}
+
+const StateAccelerator &ShengDFA::getAccelerator() const
+{
+    return accelerator_;
+}
+
+std::optional<size_t> ShengDFA::matchScalar(const char *data, size_t size) const
+{
+    uint8_t currentState = startState_;
+    std::optional<size_t> matchedIndex = std::nullopt;
+
+    if(isEndState(currentState))
+    {
+        matchedIndex = 0;
+    }
+
+    for(size_t index = 0; index < size; index++)
+    {
+        uint8_t nextState = byteRows_[static_cast<unsigned char>(data[index])][currentState];
+        if(nextState == currentState && accelerator_.isAccelerable(currentState))
+        {
+            index = accelerator_.skip(currentState, data, index + 1, size) - 1;
+        }
+        currentState = nextState;
+
+        if(currentState == deadState_)
+        {
+            break;
+        }
+
+        if(isEndState(currentState))
+        {
+            matchedIndex = index + 1;
+        }
+    }
+
+    return matchedIndex;
+}
+
+#ifdef SHENG_SSSE3
+SHENG_TARGET_SSSE3 std::optional<size_t> ShengDFA::matchSsse3(const char *data, size_t size) const
+{
+    static constexpr size_t BLOCK_SIZE = 8;
+
+    std::optional<size_t> matchedIndex = std::nullopt;
+    if(isEndState(startState_))
+    {
+        matchedIndex = 0;
+    }
+
+    // the state sits in every lane, so any lane of the shuffle result is the next state
+    __m128i state = _mm_set1_epi8(static_cast<char>(startState_));
+    uint8_t states[BLOCK_SIZE];
+
+    size_t index = 0;
+    while(index + BLOCK_SIZE <= size)
+    {
+        // the shuffles form the dependency chain, reading the state out is off to the side
+        for(size_t step = 0; step < BLOCK_SIZE; step++)
+        {
+            const __m128i row = _mm_loadu_si128(reinterpret_cast<const __m128i *>(byteRows_[static_cast<unsigned char>(data[index + step])].data()));
+            state = _mm_shuffle_epi8(row, state);
+            states[step] = static_cast<uint8_t>(_mm_cvtsi128_si32(state));
+        }
+
+        for(size_t step = 0; step < BLOCK_SIZE; step++)
+        {
+            if(states[step] == deadState_)
+            {
+                return matchedIndex;
+            }
+
+            if(isEndState(states[step]))
+            {
+                matchedIndex = index + step + 1;
+            }
+        }
+
+        index += BLOCK_SIZE;
+
+        // a block that ends looping in place is likely in a long run, the register keeps the state
+        const uint8_t lastState = states[BLOCK_SIZE - 1];
+        if(states[BLOCK_SIZE - 2] == lastState && accelerator_.isAccelerable(lastState))
+        {
+            size_t runEnd = accelerator_.skip(lastState, data, index, size);
+            if(runEnd > index && isEndState(lastState))
+            {
+                matchedIndex = runEnd;
+            }
+            index = runEnd;
+        }
+    }
+
+    uint8_t currentState = static_cast<uint8_t>(_mm_cvtsi128_si32(state));
+    for(; index < size; index++)
+    {
+        currentState = byteRows_[static_cast<unsigned char>(data[index])][currentState];
+
+        if(currentState == deadState_)
+        {
+            break;
+        }
+
+        if(isEndState(currentState))
+        {
+            matchedIndex = index + 1;
+        }
+    }
+
+    return matchedIndex;
+}
+#else
+std::optional<size_t> ShengDFA::matchSsse3(const char *data, size_t size) const
+{
+    return matchScalar(data, size);
+}
+#endif
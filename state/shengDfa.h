@@ -0,0 +1,53 @@
+#ifndef _SHENG_DFA_H_
+#define _SHENG_DFA_H_
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+#include "dfaTable.h"
+#include "stateAccelerator.h"
+
+// Sheng-style simulation of a DFA with at most 16 states (dead state included).
+// Every byte owns a 16 byte row: row[state] is the next state, so one byte shuffle with the
+// current state broadcast in every lane is one transition. The state never leaves a register,
+// which takes the table load off the critical path. Without SSSE3 the same rows are read
+// one byte at a time.
+class ShengDFA
+{
+public:
+    static constexpr size_t MAX_STATES = 16;
+
+    // null when the table does not fit, one slot is kept for the dead state
+    static std::unique_ptr<ShengDFA> fromDFATable(const DFATable &table);
+
+    //NOTICE: Longest Prefix Match
+    std::optional<size_t> match(const char *data, size_t size) const;
+
+    size_t getStateCount() const;
+    const StateAccelerator &getAccelerator() const;
+
+private:
+    ShengDFA() = default;
+
+    std::optional<size_t> matchScalar(const char *data, size_t size) const;
+    std::optional<size_t> matchSsse3(const char *data, size_t size) const;
+
+    bool isEndState(uint8_t state) const
+    {
+        return (acceptMask_ >> state) & 1u;
+    }
+
+private:
+    std::vector<std::array<uint8_t, MAX_STATES>> byteRows_;
+    StateAccelerator accelerator_;
+
+    // bit per accepting state
+    uint32_t acceptMask_ = 0;
+    uint8_t startState_ = 0;
+    uint8_t deadState_ = 0;
+    size_t stateCount_ = 0;
+};
+
+#endif // _SHENG_DFA_H_
@@ -0,0 +1,121 @@
+#include "stateAccelerator.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define STATE_ACCELERATOR_SSE2
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#ifdef STATE_ACCELERATOR_SSE2
+static inline unsigned lowestBit(unsigned mask)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+#endif
+
+StateAccelerator::StateAccelerator(const DFATable &table)
+{
+    const size_t stateCount = table.getStateCount();
+    loops_.resize(stateCount);
+
+    for(size_t state = 0; state < stateCount; state++)
+    {
+        SelfLoop loop;
+        bool fits = true;
+        size_t byte = 0;
+        while(byte < DFATable::BYTE_COUNT)
+        {
+            if(table.run(static_cast<int32_t>(state), static_cast<char>(byte)) != static_cast<int32_t>(state))
+            {
+                byte++;
+                continue;
+            }
+
+            size_t last = byte;
+            while(last + 1 < DFATable::BYTE_COUNT && table.run(static_cast<int32_t>(state), static_cast<char>(last + 1)) == static_cast<int32_t>(state))
+            {
+                last++;
+            }
+
+            if(loop.rangeCount == MAX_RANGES)
+            {
+                fits = false;
+                break;
+            }
+
+            loop.low[loop.rangeCount] = static_cast<uint8_t>(byte);
+            loop.span[loop.rangeCount] = static_cast<uint8_t>(last - byte);
+            loop.rangeCount++;
+
+            byte = last + 1;
+        }
+
+        if(fits)
+        {
+            loops_[state] = loop;
+        }
+    }
+}
+
+size_t StateAccelerator::skip(int32_t state, const char *data, size_t pos, size_t size) const
+{
+    const SelfLoop &loop = loops_[state];
+
+#ifdef STATE_ACCELERATOR_SSE2
+    // byte - low <= span, unsigned: min(byte - low, span) == byte - low
+    __m128i lows[MAX_RANGES];
+    __m128i spans[MAX_RANGES];
+    for(size_t i = 0; i < loop.rangeCount; i++)
+    {
+        lows[i] = _mm_set1_epi8(static_cast<char>(loop.low[i]));
+        spans[i] = _mm_set1_epi8(static_cast<char>(loop.span[i]));
+    }
+
+    for(; pos + 16 <= size; pos += 16)
+    {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + pos));
+
+        __m128i staying = _mm_setzero_si128();
+        for(size_t i = 0; i < loop.rangeCount; i++)
+        {
+            const __m128i offset = _mm_sub_epi8(block, lows[i]);
+            staying = _mm_or_si128(staying, _mm_cmpeq_epi8(_mm_min_epu8(offset, spans[i]), offset));
+        }
+
+        unsigned escapes = ~static_cast<unsigned>(_mm_movemask_epi8(staying)) & 0xFFFFu;
+        if(escapes != 0)
+        {
+            return pos + lowestBit(escapes);
+        }
+    }
+#endif
+
+    while(pos < size && inLoop(loop, static_cast<unsigned char>(data[pos])))
+    {
+        pos++;
+    }
+
+    return pos;
+}
+
+size_t StateAccelerator::getAcceleratedStateCount() const
+{
+    size_t count = 0;
+    for(const auto &loop : loops_)
+    {
+        if(loop.rangeCount > 0)
+        {
+            count++;
+        }
+    }
+
+    return count;
+}
@@ -0,0 +1,57 @@
+#ifndef _STATE_ACCELERATOR_H_
+#define _STATE_ACCELERATOR_H_
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "dfaTable.h"
+
+// Finds DFA states that loop on themselves for a few byte ranges (\s+, \w+, \d+ bodies)
+// and skips their runs 16 bytes at a time instead of one transition per byte.
+// State ids are the ones of the DFATable it was built from.
+class StateAccelerator
+{
+public:
+    // \w is four ranges, more would cost more compares than the transitions they save
+    static constexpr size_t MAX_RANGES = 4;
+
+    StateAccelerator() = default;
+    explicit StateAccelerator(const DFATable &table);
+
+    bool isAccelerable(int32_t state) const
+    {
+        return static_cast<size_t>(state) < loops_.size() && loops_[state].rangeCount > 0;
+    }
+
+    // first position from pos on whose byte leaves the state, size if the run reaches the end
+    size_t skip(int32_t state, const char *data, size_t pos, size_t size) const;
+
+    size_t getAcceleratedStateCount() const;
+
+private:
+    // bytes in [low, low + span] stay in the state
+    struct SelfLoop
+    {
+        uint8_t rangeCount = 0;
+        std::array<uint8_t, MAX_RANGES> low = {};
+        std::array<uint8_t, MAX_RANGES> span = {};
+    };
+
+    static bool inLoop(const SelfLoop &loop, unsigned char byte)
+    {
+        for(size_t i = 0; i < loop.rangeCount; i++)
+        {
+            if(static_cast<uint8_t>(byte - loop.low[i]) <= loop.span[i])
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+private:
+    std::vector<SelfLoop> loops_;
+};
+
+#endif // _STATE_ACCELERATOR_H_
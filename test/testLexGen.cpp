@@ -0,0 +1,65 @@
+﻿#include "gtest/gtest.h"
+#include "lexer.h"
+#include "tokenBuffer.h"
+#include "cplScanner.h"
+#include <random>
+#include <string>
+
+// cplScanner.h 由 cpl_lexgen 在构建时从 front/cpl.lex 生成
+class LexGenTest : public ::testing::Test {
+protected:
+    // 生成的扫描器必须和 Lexer::tokenize 给出同样的 token
+    void expectSameAsLexer(const std::string &text) {
+        Lexer lexer(text);
+        TokenBuffer expected;
+        lexer.tokenize(expected);
+
+        size_t pos = 0;
+        for (size_t i = 0; i < expected.size(); i++) {
+            cpl_scanner::Token token = cpl_scanner::next(text.data(), text.size(), pos);
+
+            std::string expectedName = tokenTypeToString(expected.getType(i));
+            if (expected.getType(i) == _TokenType_::EOF_TOKEN) {
+                expectedName = "END_OF_INPUT";
+            }
+            ASSERT_EQ(cpl_scanner::KIND_NAME[static_cast<size_t>(token.kind)], expectedName) << "token " << i;
+            ASSERT_EQ(token.offset, expected.getOffset(i)) << "token " << i;
+            ASSERT_EQ(token.length, expected.getLength(i)) << "token " << i;
+        }
+    }
+};
+
+TEST_F(LexGenTest, GeneratedScannerMatchesLexer) {
+    expectSameAsLexer("");
+    expectSameAsLexer("int main() { return 0; }");
+    expectSameAsLexer("if (a >= 10) { b = a - 1; } else { while (b != 0) b = b / 2; }\n");
+    expectSameAsLexer("iff ifx returned int1 _tmp 007 <=<>= \t\r\n");
+
+    // 随机拼接的样例
+    static const char *fragments[] = {
+        "if", "else", "while", "int", "return", "iff", "x", "abc", "a1", "_",
+        "0", "42", ">", ">=", "<", "<=", "=", "!=", "+", "-", "*", "/",
+        "(", ")", "{", "}", ";", ",", " ", "\n", "\t",
+    };
+    std::mt19937 random(3);
+    for (int round = 0; round < 50; round++) {
+        std::string text;
+        for (int i = 0; i < 100; i++) {
+            text += fragments[random() % (sizeof(fragments) / sizeof(fragments[0]))];
+        }
+        expectSameAsLexer(text);
+    }
+}
+
+TEST_F(LexGenTest, GeneratedScannerStopsOnUnknownByte) {
+    std::string text = "a ! b";
+    size_t pos = 0;
+
+    cpl_scanner::Token token = cpl_scanner::next(text.data(), text.size(), pos);
+    EXPECT_EQ(token.kind, cpl_scanner::TokenKind::IDENTIFIER);
+
+    token = cpl_scanner::next(text.data(), text.size(), pos);
+    EXPECT_EQ(token.kind, cpl_scanner::TokenKind::ERROR);
+    EXPECT_EQ(token.offset, 2u);
+    EXPECT_EQ(pos, 2u);
+}
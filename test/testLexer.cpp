@@ -0,0 +1,204 @@
+#include "gtest/gtest.h"
+#include "lexer.h"
+#include "tokenBuffer.h"
+#include "threadPool.h"
+#include <algorithm>
+#include <random>
+#include <string>
+#include <stdexcept>
+
+class LexerTest : public ::testing::Test {
+protected:
+    // 两个 token 流逐个比较类型、偏移和长度
+    void expectSameTokens(const TokenBuffer &actual, const TokenBuffer &expected, const std::string &context) {
+        ASSERT_EQ(actual.size(), expected.size()) << context;
+        for (size_t i = 0; i < expected.size(); i++) {
+            ASSERT_EQ(actual.getType(i), expected.getType(i)) << context << " token " << i;
+            ASSERT_EQ(actual.getOffset(i), expected.getOffset(i)) << context << " token " << i;
+            ASSERT_EQ(actual.getLength(i), expected.getLength(i)) << context << " token " << i;
+        }
+    }
+
+    // 随机片段：关键字、标识符、数字、运算符和空白。
+    // 删掉 "!=" 里的 '=' 会留下非法的 '!'，relex 此时要和 tokenize 一样抛异常
+    std::string randomText(std::mt19937 &random, size_t pieces) {
+        static const char *fragments[] = {
+            "if", "else", "while", "int", "return", "iff", "x", "abc", "a1", "_",
+            "0", "42", "007", ">", ">=", "<", "<=", "=", "!=",
+            "+", "-", "*", "/", "(", ")", "{", "}", ";", ",",
+            " ", "  ", "\n", "\t", "\r\n",
+        };
+        const size_t count = sizeof(fragments) / sizeof(fragments[0]);
+
+        std::string text;
+        for (size_t i = 0; i < pieces; i++) {
+            text += fragments[random() % count];
+        }
+        return text;
+    }
+
+    // 在 tokenizeParallel 的切分点附近放长空白和长 token，输入超过 MIN_PARALLEL_CHUNK_SIZE 的数倍
+    std::string largeText(std::mt19937 &random) {
+        std::string text;
+        while (text.size() < 1536 * 1024) {
+            text += randomText(random, 300);
+            switch (random() % 3) {
+                case 0: text += std::string(40000, ' '); break;
+                case 1: text += std::string(20000, '\n') + std::string(20000, '\t'); break;
+                default: text += " " + std::string(30000, 'y') + " "; break;
+            }
+        }
+        return text;
+    }
+
+    void expectParallelMatchesTokenize(const std::string &text) {
+        Lexer lexer(text);
+        TokenBuffer expected;
+        lexer.tokenize(expected);
+
+        for (size_t chunkCount : {0, 2, 3, 5, 16}) {
+            TokenBuffer tokens;
+            lexer.tokenizeParallel(tokens, chunkCount);
+            expectSameTokens(tokens, expected, "chunkCount " + std::to_string(chunkCount));
+        }
+    }
+};
+
+// 关键字靠模式顺序胜过 IDENTIFIER，只在整个词相同时成立
+TEST_F(LexerTest, KeywordsBeatIdentifiers) {
+    const std::string text = "if int return else while iff int1 returns elsewhere _while";
+    const _TokenType_ expected[] = {
+        _TokenType_::IF, _TokenType_::INT, _TokenType_::RETURN, _TokenType_::ELSE, _TokenType_::WHILE,
+        _TokenType_::IDENTIFIER, _TokenType_::IDENTIFIER, _TokenType_::IDENTIFIER, _TokenType_::IDENTIFIER, _TokenType_::IDENTIFIER,
+        _TokenType_::EOF_TOKEN,
+    };
+    const size_t count = sizeof(expected) / sizeof(expected[0]);
+
+    Lexer lexer(text);
+    for (size_t i = 0; i < count; i++) {
+        EXPECT_EQ(lexer.getNextToken()->type, expected[i]) << "getNextToken " << i;
+    }
+
+    TokenBuffer tokens;
+    lexer.tokenize(tokens);
+    ASSERT_EQ(tokens.size(), count);
+    for (size_t i = 0; i < count; i++) {
+        EXPECT_EQ(tokens.getType(i), expected[i]) << "tokenize " << i << " " << tokens.getLexeme(i);
+    }
+}
+
+TEST_F(LexerTest, RelexMatchesTokenize) {
+    std::mt19937 random(20240601);
+
+    Lexer lexer;
+    TokenBuffer tokens;
+    std::string text = randomText(random, 200);
+    lexer.setInput(text);
+    lexer.tokenize(tokens);
+
+    for (int round = 0; round < 2000; round++) {
+        // 编辑位置：开头、末尾，或者随机（常常落在 token 中间）
+        size_t offset = 0;
+        switch (random() % 4) {
+            case 0: offset = 0; break;
+            case 1: offset = text.size(); break;
+            default: offset = random() % (text.size() + 1); break;
+        }
+        size_t removed = std::min<size_t>(random() % 6, text.size() - offset);
+        std::string inserted = randomText(random, random() % 4);
+
+        const std::string removedText = text.substr(offset, removed);
+        text.replace(offset, removed, inserted);
+        std::string context = "round " + std::to_string(round) + " edit at " + std::to_string(offset);
+
+        TokenBuffer expected;
+        Lexer reference(text);
+        bool expectThrow = false;
+        try {
+            reference.tokenize(expected);
+        } catch (const std::runtime_error &) {
+            expectThrow = true;
+        }
+
+        if (expectThrow) {
+            EXPECT_THROW(lexer.relex(tokens, offset, removed, inserted), std::runtime_error) << context;
+            // 撤销这次编辑，让后面的轮次继续在合法输入上进行；抛出后 token 需要重新整体构建
+            text.replace(offset, inserted.size(), removedText);
+            lexer.setInput(text);
+            lexer.tokenize(tokens);
+            continue;
+        }
+
+        lexer.relex(tokens, offset, removed, inserted);
+        expectSameTokens(tokens, expected, context);
+        EXPECT_EQ(tokens.getSource(), text) << context;
+        if (::testing::Test::HasFatalFailure()) {
+            return;
+        }
+    }
+}
+
+TEST_F(LexerTest, RelexRejectsEditOutOfRange) {
+    Lexer lexer("a b");
+    TokenBuffer tokens;
+    lexer.tokenize(tokens);
+
+    EXPECT_THROW(lexer.relex(tokens, 4, 0, "c"), std::out_of_range);
+    EXPECT_THROW(lexer.relex(tokens, 2, 2, ""), std::out_of_range);
+}
+
+TEST_F(LexerTest, TokenizeParallelMatchesTokenize) {
+    std::mt19937 random(7);
+    expectParallelMatchesTokenize(largeText(random));
+
+    // 切分点正好落在一段很长的空白中间
+    std::string blank = randomText(random, 100) + std::string(1024 * 1024, ' ') + randomText(random, 100) + std::string(512 * 1024, '\n') + "end";
+    expectParallelMatchesTokenize(blank);
+
+    // 切分点落在一个很长的标识符中间，边界要向后找到空白
+    std::string longToken = "a " + std::string(1024 * 1024, 'x') + " b " + std::string(1024 * 1024, '7') + " c";
+    expectParallelMatchesTokenize(longToken);
+}
+
+TEST_F(LexerTest, TokenizeParallelInsidePoolTask) {
+    std::mt19937 random(5);
+    const std::string text = largeText(random);
+
+    Lexer lexer(text);
+    TokenBuffer expected;
+    lexer.tokenize(expected);
+
+    // 在线程池任务里调用时顺序执行，不会等待排在自己后面的任务
+    TokenBuffer tokens;
+    ThreadPool::getInstance().submit([&lexer, &tokens]() { lexer.tokenizeParallel(tokens, 4); }).get();
+    expectSameTokens(tokens, expected, "pool task");
+}
+
+TEST_F(LexerTest, TokenizeParallelReportsFirstUnknownToken) {
+    std::mt19937 random(11);
+    std::string text = largeText(random);
+    // 后面的块也有非法字符，报告的应该是最靠前的那个
+    text[text.size() / 3] = '!';
+    text[text.size() / 3 + 1] = ' ';
+    text[text.size() - 10] = '!';
+    text[text.size() - 9] = ' ';
+
+    Lexer lexer(text);
+    TokenBuffer tokens;
+    std::string expected;
+    try {
+        lexer.tokenize(tokens);
+    } catch (const std::runtime_error &e) {
+        expected = e.what();
+    }
+    ASSERT_FALSE(expected.empty());
+
+    for (size_t chunkCount : {2, 4, 6}) {
+        try {
+            lexer.tokenizeParallel(tokens, chunkCount);
+            ADD_FAILURE() << "chunkCount " << chunkCount << " did not throw";
+        } catch (const std::runtime_error &e) {
+            EXPECT_EQ(std::string(e.what()), expected) << "chunkCount " << chunkCount;
+        }
+    }
+}
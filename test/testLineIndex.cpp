@@ -0,0 +1,114 @@
+﻿#include "gtest/gtest.h"
+#include "lineIndex.h"
+#include "tokenBuffer.h"
+#include <string>
+
+class LineIndexTest : public ::testing::Test {
+protected:
+    LineIndex lines;
+
+    // 逐字节数出来的行列，作为对照
+    SourceLocation naiveLocate(const std::string &source, size_t offset) {
+        SourceLocation location{1, 1};
+        for (size_t i = 0; i < offset; i++) {
+            if (source[i] == '\n') {
+                location.line++;
+                location.column = 1;
+            } else {
+                location.column++;
+            }
+        }
+        return location;
+    }
+
+    void expectMatchesNaive(const std::string &source) {
+        lines.build(source);
+        for (size_t offset = 0; offset <= source.size(); offset++) {
+            SourceLocation expected = naiveLocate(source, offset);
+            SourceLocation actual = lines.locate(offset);
+            EXPECT_EQ(actual.line, expected.line) << "offset " << offset;
+            EXPECT_EQ(actual.column, expected.column) << "offset " << offset;
+        }
+    }
+};
+
+TEST_F(LineIndexTest, EmptyInput) {
+    lines.build("");
+
+    EXPECT_TRUE(lines.isBuilt());
+    EXPECT_EQ(lines.getLineCount(), 1);
+    SourceLocation location = lines.locate(0);
+    EXPECT_EQ(location.line, 1);
+    EXPECT_EQ(location.column, 1);
+}
+
+TEST_F(LineIndexTest, OffsetAtNewline) {
+    // '\n' 属于它结束的那一行
+    lines.build("ab\ncd");
+
+    SourceLocation location = lines.locate(2);
+    EXPECT_EQ(location.line, 1);
+    EXPECT_EQ(location.column, 3);
+
+    location = lines.locate(3);
+    EXPECT_EQ(location.line, 2);
+    EXPECT_EQ(location.column, 1);
+}
+
+TEST_F(LineIndexTest, LastLineWithoutNewline) {
+    lines.build("a\nb\nlast");
+
+    EXPECT_EQ(lines.getLineCount(), 3);
+    SourceLocation location = lines.locate(7);
+    EXPECT_EQ(location.line, 3);
+    EXPECT_EQ(location.column, 4);
+
+    // 末尾偏移（EOF token 的位置）
+    location = lines.locate(8);
+    EXPECT_EQ(location.line, 3);
+    EXPECT_EQ(location.column, 5);
+}
+
+TEST_F(LineIndexTest, TrailingNewlineStartsEmptyLine) {
+    lines.build("a\n");
+
+    EXPECT_EQ(lines.getLineCount(), 2);
+    SourceLocation location = lines.locate(2);
+    EXPECT_EQ(location.line, 2);
+    EXPECT_EQ(location.column, 1);
+}
+
+TEST_F(LineIndexTest, SpansLongerThanSixteenBytes) {
+    // 超过 16 字节的行和跨 16 字节块边界的换行都要走 SSE2 路径
+    expectMatchesNaive(std::string(40, 'x') + "\n" + std::string(15, 'y') + "\n\n" + std::string(16, 'z') + "\n" + "tail");
+
+    std::string dense;
+    for (int i = 0; i < 50; i++) {
+        dense += (i % 3 == 0) ? "\n" : "ab";
+    }
+    expectMatchesNaive(dense);
+
+    expectMatchesNaive(std::string(100, '\n'));
+}
+
+TEST_F(LineIndexTest, ClearDropsIndex) {
+    lines.build("a\nb");
+    lines.clear();
+
+    EXPECT_FALSE(lines.isBuilt());
+}
+
+TEST_F(LineIndexTest, TokenBufferResolvesPositions) {
+    std::string source = "x\n  yy";
+    lines.build(source);
+
+    TokenBuffer tokens;
+    tokens.setSource(source);
+    tokens.push(_TokenType_::IDENTIFIER, 0, 1);
+    tokens.push(_TokenType_::IDENTIFIER, 4, 2);
+
+    Token token = tokens.getToken(1, lines);
+    EXPECT_EQ(token.lexeme, "yy");
+    EXPECT_EQ(token.line, 2);
+    EXPECT_EQ(token.column, 3);
+}
@@ -0,0 +1,90 @@
+﻿#include "gtest/gtest.h"
+#include "mappedFile.h"
+#include "lexer.h"
+#include "tokenBuffer.h"
+#include "workShop.h"
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+class MappedFileTest : public ::testing::Test {
+protected:
+    std::string writeFile(const std::string &name, const std::string &content) {
+        std::string path = ::testing::TempDir() + name;
+        std::ofstream output(path, std::ios::binary | std::ios::trunc);
+        output.write(content.data(), static_cast<std::streamsize>(content.size()));
+        return path;
+    }
+};
+
+// 空文件不做映射，得到空视图，词法分析只给出 EOF
+TEST_F(MappedFileTest, EmptyFile) {
+    const std::string path = writeFile("cpl_empty.src", "");
+
+    MappedFile mappedFile(path);
+    EXPECT_EQ(mappedFile.size(), 0);
+    EXPECT_TRUE(mappedFile.view().empty());
+
+    Lexer lexer;
+    lexer.openFile(path);
+    TokenBuffer tokens;
+    lexer.tokenize(tokens);
+    ASSERT_EQ(tokens.size(), 1);
+    EXPECT_EQ(tokens.getType(0), _TokenType_::EOF_TOKEN);
+}
+
+TEST_F(MappedFileTest, MissingFile) {
+    const std::string path = ::testing::TempDir() + "cpl_missing.src";
+    std::remove(path.c_str());
+
+    EXPECT_THROW(MappedFile mappedFile(path), std::runtime_error);
+
+    // 打开失败时原来的输入保持不变
+    Lexer lexer("a b");
+    EXPECT_THROW(lexer.openFile(path), std::runtime_error);
+    TokenBuffer tokens;
+    lexer.tokenize(tokens);
+    EXPECT_EQ(tokens.size(), 3);
+
+    WorkShop workShop;
+    EXPECT_THROW(workShop.loadProgramFile(path), std::runtime_error);
+}
+
+// 从映射的文件词法分析，结果与 setInput 同样的内容一致
+TEST_F(MappedFileTest, MappedFileLexesLikeSetInput) {
+    std::string source;
+    for (int i = 0; i < 2000; i++) {
+        source += "int x" + std::to_string(i) + " = " + std::to_string(i * 7) + ";\n";
+        source += "if (x" + std::to_string(i) + " >= 10) { return x" + std::to_string(i) + " * 2; }\r\n\t";
+    }
+    const std::string path = writeFile("cpl_program.src", source);
+
+    MappedFile mappedFile(path);
+    EXPECT_EQ(mappedFile.view(), source);
+
+    Lexer fileLexer;
+    fileLexer.openFile(path);
+    TokenBuffer fileTokens;
+    fileLexer.tokenize(fileTokens);
+
+    Lexer stringLexer;
+    stringLexer.setInput(source);
+    TokenBuffer stringTokens;
+    stringLexer.tokenize(stringTokens);
+
+    ASSERT_EQ(fileTokens.size(), stringTokens.size());
+    for (size_t i = 0; i < stringTokens.size(); i++) {
+        ASSERT_EQ(fileTokens.getType(i), stringTokens.getType(i)) << "token " << i;
+        ASSERT_EQ(fileTokens.getOffset(i), stringTokens.getOffset(i)) << "token " << i;
+        ASSERT_EQ(fileTokens.getLexeme(i), stringTokens.getLexeme(i)) << "token " << i;
+    }
+    EXPECT_EQ(fileLexer.getLocation(source.size()).line, stringLexer.getLocation(source.size()).line);
+
+    // WorkShop 从文件加载与直接给源码编译出同样的程序
+    const std::string programPath = writeFile("cpl_expr.src", "1+3*5");
+    WorkShop workShop;
+    std::vector<std::string> fromFile = workShop.loadProgramFile(programPath);
+    EXPECT_EQ(fromFile, workShop.loadProgram("1+3*5"));
+    EXPECT_FALSE(fromFile.empty());
+}
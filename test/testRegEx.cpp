@@ -1,13 +1,21 @@
 ﻿#include "gtest/gtest.h"
 #include "regEx.h"
+#include "regExSet.h"
+#include "staticRegEx.h"
+#include "regExCache.h"
+#include "regExParser.h"
+#include "regExSimplifier.h"
+#include "regExCharSetNode.h"
+#include "regExOptionalNode.h"
 #include "regExCharNode.h"           // 字符节点
 #include "regExConcatenationNode.h"  // 连接节点
 #include "regExAlternationNode.h"    // 或操作节点
 #include "regExKleeneStarNode.h"     // 闭包节点
-#include "nfaState.h"                // NFAState, 假设其中定义了 CompareNfaStateSharedPtr
 #include "alphaBet.h"                // 字母表单例
-
-// 假设 CompareNfaStateSharedPtr 已经正确实现，用于 std::set<std::shared_ptr<NFAState>>
+#include "threadPool.h"
+#include <cstring>
+#include <fstream>
+#include <iterator>
 
 // --- Test Fixture ---
 // 使用测试夹具来在每个测试前初始化 Alphabet
@@ -364,4 +372,609 @@ TEST_F(RegExTest, NeverMatch) {
     // 匹配 "x"，期望失败 ("a" 永远不会匹配 "x")
     auto result = regex.match("x");
     EXPECT_FALSE(result.has_value());
-}
\ No newline at end of file
+}
+// 最小化：(a|b)*abb 的子集构造得到 5 个状态，最小 DFA 只有 4 个
+TEST_F(RegExTest, MinimizedStateCount) {
+    auto ab_union_star = KleeneStar(Alternation(Char('a'), Char('b')));
+    auto root = Concat(ab_union_star, Concat(Char('a'), Concat(Char('b'), Char('b'))));
+    RegEx regex(root);
+
+    EXPECT_EQ(regex.getStats().dfaStateCount, 5);
+    EXPECT_EQ(regex.getStats().minimizedDfaStateCount, 4);
+
+    EXPECT_EQ(regex.match("abababb").value(), 7);
+    EXPECT_FALSE(regex.match("abab").has_value());
+}
+
+// 最小化不改变匹配结果
+TEST_F(RegExTest, MinimizedParsedPatterns) {
+    RegEx identifier("\\w+");
+    EXPECT_EQ(identifier.getStats().minimizedDfaStateCount, 2);
+    EXPECT_EQ(identifier.match("abc_123 x").value(), 7);
+    EXPECT_FALSE(identifier.match(" abc").has_value());
+
+    RegEx alternation("(a|b|c|d)(a|b|c|d)*");
+    EXPECT_LE(alternation.getStats().minimizedDfaStateCount, alternation.getStats().dfaStateCount);
+    EXPECT_EQ(alternation.getStats().minimizedDfaStateCount, 2);
+    EXPECT_EQ(alternation.match("abcdx").value(), 4);
+}
+
+// 字节等价类：\w+ 只需要区分 单词字符 / 其余字母表字符 / 字母表外字节
+TEST_F(RegExTest, ByteClassCount) {
+    RegEx identifier("\\w+");
+    EXPECT_EQ(identifier.getStats().byteClassCount, 3);
+    EXPECT_EQ(identifier.match("abc_123+").value(), 7);
+
+    RegEx negated("[^a]+");
+    EXPECT_EQ(negated.getStats().byteClassCount, 3);
+    EXPECT_EQ(negated.match("bcd a").value(), 4);
+    EXPECT_FALSE(negated.match("abc").has_value());
+
+    // 字母表外的字节没有转移
+    EXPECT_EQ(negated.match(std::string("bc\x01") + "d").value(), 2);
+}
+
+// 惰性 DFA：状态在第一次走到时才构造
+TEST_F(RegExTest, LazyDfaMatch) {
+    RegExOptions options;
+    options.mode = RegExMode::LAZY_DFA;
+
+    RegEx regex("(a|b)*abb", options);
+    EXPECT_EQ(regex.getStats().dfaStateCount, 1);
+
+    EXPECT_EQ(regex.match("abababb").value(), 7);
+    EXPECT_EQ(regex.match("abbb").value(), 3);
+    EXPECT_FALSE(regex.match("abab").has_value());
+    EXPECT_FALSE(regex.match("").has_value());
+    EXPECT_EQ(regex.getStats().lazyCacheFlushCount, 0);
+
+    RegEx star("(ab)*", options);
+    EXPECT_EQ(star.match("ababa").value(), 4);
+    EXPECT_EQ(star.match("x").value(), 0);
+}
+
+// 缓存超过预算时清空重建，结果不变
+TEST_F(RegExTest, LazyDfaCacheFlush) {
+    RegExOptions options;
+    options.mode = RegExMode::LAZY_DFA;
+    options.lazyCacheBudget = 0;
+
+    RegEx regex("(a|b)*a(a|b)(a|b)(a|b)", options);
+    RegEx eager("(a|b)*a(a|b)(a|b)(a|b)");
+
+    const std::string inputs[] = {"abbb", "babab", "aaaabbbbab", "bbbb", "abaabbbaaab"};
+    for (const auto &input : inputs) {
+        EXPECT_EQ(regex.match(input), eager.match(input)) << input;
+    }
+    EXPECT_GT(regex.getStats().lazyCacheFlushCount, 0);
+}
+
+// Pike VM：直接模拟 NFA，结果与 DFA 一致
+TEST_F(RegExTest, PikeVmMatch) {
+    RegExOptions options;
+    options.mode = RegExMode::PIKE_VM;
+
+    RegEx regex("(a|b)*abb", options);
+    EXPECT_EQ(regex.getEngine(), RegExEngine::PIKE_VM);
+    EXPECT_EQ(regex.match("abababb").value(), 7);
+    EXPECT_EQ(regex.match("abbb").value(), 3);
+    EXPECT_FALSE(regex.match("abab").has_value());
+
+    RegEx nested("(a*)*b?", options);
+    EXPECT_EQ(nested.match("aaab").value(), 4);
+    EXPECT_EQ(nested.match("c").value(), 0);
+
+    RegEx charSet("[^a]+\\d", options);
+    EXPECT_EQ(charSet.match("bc1d2a").value(), 5);
+}
+
+// 超过 DFA 状态预算时退回 Pike VM
+TEST_F(RegExTest, PikeVmFallback) {
+    RegExOptions options;
+    options.maxDfaStates = 8;
+
+    // (a|b)*a(a|b)(a|b)(a|b)(a|b) 的 DFA 需要 32 个状态
+    RegEx regex("(a|b)*a(a|b)(a|b)(a|b)(a|b)", options);
+    EXPECT_EQ(regex.getEngine(), RegExEngine::PIKE_VM);
+
+    RegEx eager("(a|b)*a(a|b)(a|b)(a|b)(a|b)");
+    EXPECT_EQ(eager.getEngine(), RegExEngine::DFA);
+
+    const std::string inputs[] = {"abbbb", "babab", "aaaabbbbab", "bbbbb", "abaabbbaaab"};
+    for (const auto &input : inputs) {
+        EXPECT_EQ(regex.match(input), eager.match(input)) << input;
+    }
+}
+
+// 病态模式 (a?)^n a^n：子集构造在预算用完时就放弃，很快退回 Pike VM
+TEST_F(RegExTest, PikeVmFallbackOnPathologicalPattern) {
+    const size_t n = 1000;
+    std::string pattern;
+    for (size_t i = 0; i < n; i++) {
+        pattern += "a?";
+    }
+    pattern += std::string(n, 'a');
+
+    RegEx regex(pattern);
+    EXPECT_EQ(regex.getEngine(), RegExEngine::PIKE_VM);
+    EXPECT_FALSE(regex.match(std::string(n - 1, 'a')).has_value());
+    EXPECT_EQ(regex.match(std::string(n, 'a')).value(), n);
+    EXPECT_EQ(regex.match(std::string(2 * n + 1, 'a')).value(), 2 * n);
+
+    // (a?)^100 的 NFA 本身就超出内存预算，一个状态都不展开
+    RegExOptions options;
+    options.maxDfaMemory = 1 << 10;
+    RegEx small(pattern.substr(0, 200), options);
+    EXPECT_EQ(small.getEngine(), RegExEngine::PIKE_VM);
+    EXPECT_EQ(small.match("aaa").value(), 3);
+}
+
+// 多模式集合：一次最长匹配同时给出长度和获胜的模式
+TEST_F(RegExTest, RegExSetLongestMatch) {
+    RegExSet regExSet({"\\d+", "\\w+", "(<)", "(<=)", "(=)"});
+    EXPECT_EQ(regExSet.getPatternCount(), 5);
+
+    auto result = regExSet.match("123+");
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->length, 3);
+    EXPECT_EQ(result->patternId, 0); // 与 \w+ 等长，先加入的 \d+ 获胜
+
+    result = regExSet.match("12ab");
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->length, 4);
+    EXPECT_EQ(result->patternId, 1);
+
+    result = regExSet.match("<=1");
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->length, 2);
+    EXPECT_EQ(result->patternId, 3);
+
+    result = regExSet.match("<1");
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->length, 1);
+    EXPECT_EQ(result->patternId, 2);
+
+    EXPECT_FALSE(regExSet.match("+").has_value());
+    EXPECT_FALSE(regExSet.match("").has_value());
+}
+
+// 直接在 string_view 上匹配：视图可以从缓冲区中间开始、后面没有 '\0'，也可以含有 '\0'
+TEST_F(RegExTest, MatchOnStringView) {
+    const std::string text = "zzaabbzz";
+    const std::string_view middle = std::string_view(text).substr(2, 4); // "aabb"
+    const std::string_view cut(text.data() + 2, 3);                       // "aab"，缓冲区后面还有 'b'
+    const std::string_view withNull("aa\0bb", 5);
+
+    RegExOptions lazyOptions;
+    lazyOptions.mode = RegExMode::LAZY_DFA;
+    RegExOptions pikeOptions;
+    pikeOptions.mode = RegExMode::PIKE_VM;
+    RegExOptions automatonOptions;
+    automatonOptions.specializeSimplePatterns = false;
+
+    for (const RegExOptions &options : {RegExOptions(), lazyOptions, pikeOptions, automatonOptions}) {
+        RegEx regex("a+b*", options);
+        EXPECT_EQ(regex.match(middle).value(), 4);
+        EXPECT_EQ(regex.match(cut).value(), 3);
+        EXPECT_EQ(regex.match(withNull).value(), 2);
+
+        // CHARSET_RUN
+        RegEx run("[^z]+", options);
+        EXPECT_EQ(run.match(middle).value(), 4);
+        EXPECT_EQ(run.match(cut).value(), 3);
+        EXPECT_EQ(run.match(withNull).value(), 2);
+
+        // LITERAL：视图比字面量短时，即使缓冲区后面的字节正好对得上也不匹配
+        RegEx literal("aabb", options);
+        EXPECT_EQ(literal.match(middle).value(), 4);
+        EXPECT_FALSE(literal.match(cut).has_value());
+        EXPECT_FALSE(literal.match(withNull).has_value());
+    }
+
+    RegExSet regExSet({"a+", "b+", "a+b"});
+    auto result = regExSet.match(middle);
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->length, 3);
+    EXPECT_EQ(result->patternId, 2);
+
+    result = regExSet.match(std::string_view(text.data() + 2, 2)); // "aa"
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->length, 2);
+    EXPECT_EQ(result->patternId, 0);
+
+    result = regExSet.match(withNull.substr(2)); // "\0bb"
+    EXPECT_FALSE(result.has_value());
+    result = regExSet.match(withNull);
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->length, 2);
+}
+
+// 编译期构建的 DFA：与运行时 RegExSet 给出相同的最长匹配和模式编号
+TEST_F(RegExTest, StaticRegExMatchesRuntime) {
+    static constexpr std::string_view patterns[] = {"if", "\\d+", "\\w+", "[^a-z\\s]", "(<|<=)(=)?"};
+    static constexpr auto dfa = StaticRegExCompiler<32, 32, 32>::compile(patterns);
+
+    static_assert(dfa.match("iff").value() == 3, "longest match at compile time");
+    static_assert(!dfa.match(" ").has_value(), "whitespace is excluded");
+
+    RegExSet staticSet(dfa.toDFATable(), 5);
+    RegExSet runtimeSet({"if", "\\d+", "\\w+", "[^a-z\\s]", "(<|<=)(=)?"});
+
+    const std::string inputs[] = {"if", "iff", "if(", "12a", "42", "<==", "<=", "#", "A1", " x", ""};
+    for (const auto &input : inputs) {
+        auto expected = runtimeSet.match(input);
+        auto actual = staticSet.match(input);
+        ASSERT_EQ(actual.has_value(), expected.has_value()) << input;
+        if (expected.has_value()) {
+            EXPECT_EQ(actual->length, expected->length) << input;
+            EXPECT_EQ(actual->patternId, expected->patternId) << input;
+        }
+    }
+}
+
+// 保存后重新加载 (映射文件原地使用)：匹配结果与原 DFA 一致
+TEST_F(RegExTest, SaveAndLoadDFA) {
+    const std::string path = ::testing::TempDir() + "cpl_regex_set.dfa";
+
+    RegExSet regExSet({"if", "\\d+", "\\w+", "(<)", "(<=)"});
+    regExSet.save(path);
+
+    RegExSet loaded(DFATable::load(path), regExSet.getPatternCount());
+    EXPECT_EQ(loaded.getDFATable().getStateCount(), regExSet.getDFATable().getStateCount());
+
+    // 接受标记 (模式编号) 超出模式个数的表会让 Lexer 越界，直接拒绝
+    EXPECT_THROW(RegExSet(DFATable::load(path), regExSet.getPatternCount() - 1), std::runtime_error);
+
+    const std::string inputs[] = {"if", "iff", "12a", "42", "<=", "<1", "+", ""};
+    for (const auto &input : inputs) {
+        auto expected = regExSet.match(input);
+        auto actual = loaded.match(input);
+        ASSERT_EQ(actual.has_value(), expected.has_value()) << input;
+        if (expected.has_value()) {
+            EXPECT_EQ(actual->length, expected->length) << input;
+            EXPECT_EQ(actual->patternId, expected->patternId) << input;
+        }
+    }
+
+    // 加载的表只读，复制后仍然可用
+    DFATable copy = loaded.getDFATable();
+    EXPECT_THROW(copy.addState(DFATable::NO_ACCEPT), std::logic_error);
+    EXPECT_EQ(copy.run(copy.getStartState(), 'i'), loaded.getDFATable().run(0, 'i'));
+
+    RegEx regex("a(b|c)*");
+    regex.save(path);
+    RegEx loadedRegex(DFATable::load(path));
+    EXPECT_EQ(loadedRegex.match("abcbx"), regex.match("abcbx"));
+
+    EXPECT_THROW(DFATable::load(path + ".missing"), std::runtime_error);
+
+    // 损坏的文件：头部之后依次是 256 字节的字节类映射、每个状态的接受标记和转移表
+    regExSet.save(path);
+    std::string bytes;
+    {
+        std::ifstream input(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+    }
+    const size_t headerSize = 24;
+    const size_t stateCount = regExSet.getDFATable().getStateCount();
+    const size_t classCount = regExSet.getDFATable().getClassCount();
+    const size_t transitionOffset = headerSize + DFATable::BYTE_COUNT + stateCount * sizeof(int32_t);
+    ASSERT_EQ(bytes.size(), transitionOffset + stateCount * classCount * sizeof(int32_t));
+
+    auto expectCorrupt = [&](const std::string &corrupt) {
+        {
+            std::ofstream output(path, std::ios::binary | std::ios::trunc);
+            output.write(corrupt.data(), corrupt.size());
+        }
+        try {
+            DFATable::load(path);
+            ADD_FAILURE() << "corrupt file loaded";
+        } catch (const std::runtime_error &e) {
+            EXPECT_NE(std::string(e.what()).find("corrupt DFA file"), std::string::npos) << e.what();
+        }
+    };
+
+    auto withInt32 = [&](size_t offset, int32_t value) {
+        std::string corrupt = bytes;
+        std::memcpy(&corrupt[offset], &value, sizeof(value));
+        return corrupt;
+    };
+
+    expectCorrupt(withInt32(transitionOffset + 4 * sizeof(int32_t), static_cast<int32_t>(stateCount)));
+    expectCorrupt(withInt32(transitionOffset, -2));
+    expectCorrupt(withInt32(headerSize + DFATable::BYTE_COUNT, -7));
+
+    std::string badClass = bytes;
+    badClass[headerSize + 'a'] = static_cast<char>(classCount);
+    expectCorrupt(badClass);
+
+    expectCorrupt(bytes.substr(0, bytes.size() - 1));
+    expectCorrupt(bytes + "x");
+
+    // 原样写回的文件仍然可以加载
+    {
+        std::ofstream output(path, std::ios::binary | std::ios::trunc);
+        output.write(bytes.data(), bytes.size());
+    }
+    EXPECT_NO_THROW(DFATable::load(path));
+}
+
+// 全局缓存：相同模式和选项共享同一个编译结果，超出容量时淘汰最久未用的
+TEST_F(RegExTest, RegExCacheSharesCompiled) {
+    RegExCache &cache = RegExCache::instance();
+    cache.clear();
+    cache.setCapacity(2);
+
+    auto first = cache.getRegEx("(a|b)*c");
+    auto second = cache.getRegEx("(a|b)*c");
+    EXPECT_EQ(first.get(), second.get());
+    EXPECT_EQ(second->match("abac"), 4);
+
+    RegExOptions pikeOptions;
+    pikeOptions.mode = RegExMode::PIKE_VM;
+    auto pike = cache.getRegEx("(a|b)*c", pikeOptions);
+    EXPECT_NE(pike.get(), first.get());
+    EXPECT_EQ(pike->getEngine(), RegExEngine::PIKE_VM);
+
+    RegExCacheStats stats = cache.getStats();
+    EXPECT_EQ(stats.hitCount, 1);
+    EXPECT_EQ(stats.missCount, 2);
+    EXPECT_EQ(stats.entryCount, 2);
+
+    auto set = cache.getRegExSet({"\\d+", "\\w+"});
+    EXPECT_EQ(set->match("12a")->patternId, 1);
+    EXPECT_EQ(cache.getStats().evictionCount, 1);
+
+    // 被淘汰的条目仍然被持有者使用，重新获取会再编译
+    EXPECT_EQ(first->match("bc"), 2);
+    EXPECT_NE(cache.getRegEx("(a|b)*c").get(), first.get());
+
+    cache.setCapacity(RegExCache::DEFAULT_CAPACITY);
+    cache.clear();
+}
+
+// 非锚定搜索：反向 DFA 找出匹配起点，正向取最长匹配
+TEST_F(RegExTest, SearchAndFindAll) {
+    RegEx regex("ab+|c");
+
+    auto found = regex.search("xxabbbc");
+    ASSERT_TRUE(found.has_value());
+    EXPECT_EQ(found->offset, 2);
+    EXPECT_EQ(found->length, 4);
+
+    found = regex.search("xxabbbc", 3);
+    ASSERT_TRUE(found.has_value());
+    EXPECT_EQ(found->offset, 6);
+    EXPECT_EQ(found->length, 1);
+
+    EXPECT_FALSE(regex.search("xxaxx").has_value());
+
+    std::vector<RegExMatch> matches = regex.findAll("abcab ab");
+    ASSERT_EQ(matches.size(), 4);
+    EXPECT_EQ(matches[1].offset, 2);
+    EXPECT_EQ(matches[3].offset, 6);
+    EXPECT_EQ(matches[3].length, 2);
+
+    // 可空模式在每个位置都有匹配，空匹配后前进一个字节
+    RegEx optional("a*");
+    matches = optional.findAll("baa");
+    ASSERT_EQ(matches.size(), 3);
+    EXPECT_EQ(matches[0].length, 0);
+    EXPECT_EQ(matches[1].offset, 1);
+    EXPECT_EQ(matches[1].length, 2);
+    EXPECT_EQ(matches[2].offset, 3);
+
+    // 从 DFATable 构造时没有语法树，逐个位置尝试
+    RegEx loaded(RegExSet({"ab+|c"}).getDFATable());
+    EXPECT_EQ(loaded.findAll("abcab ab").size(), 4);
+}
+
+// 长输入：每个匹配之后的扫描都要跑到结尾才知道没有更长的匹配，不能每次都重扫
+TEST_F(RegExTest, SearchAndFindAllStayLinear) {
+    const std::string input(1 << 20, 'a');
+
+    // 'a' 处处匹配，"a+b" 却要看到结尾才失败
+    RegEx regex("a+b|a");
+    std::vector<RegExMatch> matches = regex.findAll(input);
+    ASSERT_EQ(matches.size(), input.size());
+    EXPECT_EQ(matches.back().offset, input.size() - 1);
+    EXPECT_EQ(matches.back().length, 1);
+
+    RegEx loaded(RegExSet({"a+b|a"}).getDFATable());
+    EXPECT_EQ(loaded.findAll(input).size(), input.size());
+
+    // search 不再反向扫描整个尾部：匹配在开头时，后面再长也只扫到匹配结束的地方
+    const std::string prefixed = "xxab" + std::string(1 << 20, 'x');
+    RegEx notX("[^x]+b?");
+    for (int i = 0; i < 4096; i++) {
+        std::optional<RegExMatch> found = notX.search(prefixed);
+        ASSERT_TRUE(found.has_value());
+        ASSERT_EQ(found->offset, 2);
+        ASSERT_EQ(found->length, 2);
+    }
+
+    // 特化引擎
+    RegEx literal("ab");
+    std::string text;
+    for (int i = 0; i < 100000; i++) {
+        text += "xab";
+    }
+    EXPECT_EQ(literal.findAll(text).size(), 100000);
+
+    RegEx run("[ab]+");
+    matches = run.findAll(text);
+    ASSERT_EQ(matches.size(), 100000);
+    EXPECT_EQ(matches[1].offset, 4);
+    EXPECT_EQ(matches[1].length, 2);
+}
+
+// 批量匹配：多线程结果与逐个 match 一致
+TEST_F(RegExTest, MatchManyAgreesWithMatch) {
+    RegEx regex("[a-z_][a-z0-9_]*");
+
+    std::vector<std::string> storage;
+    for(size_t i = 0; i < 3 * RegEx::MIN_PARALLEL_BATCH_SIZE; i++) {
+        storage.push_back((i % 3 == 0) ? "9abc" : "id_" + std::to_string(i));
+    }
+    std::vector<std::string_view> inputs(storage.begin(), storage.end());
+
+    std::vector<std::optional<size_t>> results = regex.matchMany(inputs);
+    ASSERT_EQ(results.size(), inputs.size());
+    for(size_t i = 0; i < inputs.size(); i++) {
+        EXPECT_EQ(results[i], regex.match(inputs[i]));
+    }
+
+    EXPECT_TRUE(regex.matchMany({}).empty());
+
+    // 在线程池任务里调用时就地执行，占满所有工作线程也不会死锁
+    ThreadPool &pool = ThreadPool::getInstance();
+    EXPECT_FALSE(pool.isWorkerThread());
+    std::vector<std::future<size_t>> nested;
+    for(size_t i = 0; i < pool.getThreadCount() + 1; i++) {
+        nested.push_back(pool.submit([&regex, &inputs, &pool]() {
+            EXPECT_TRUE(pool.isWorkerThread());
+            return regex.matchMany(inputs).size();
+        }));
+    }
+    for(auto &result : nested) {
+        EXPECT_EQ(result.get(), inputs.size());
+    }
+}
+
+// 状态数少于 16 的 DFA 使用 Sheng 引擎，结果与 Pike VM 一致
+TEST_F(RegExTest, ShengMatchesPikeVm) {
+    RegExOptions pikeOptions;
+    pikeOptions.mode = RegExMode::PIKE_VM;
+
+    // 字面量和字符集闭包默认走特化引擎，这里关掉特化，让它们也构建 DFA
+    RegExOptions automatonOptions;
+    automatonOptions.specializeSimplePatterns = false;
+
+    const std::string patterns[] = {"\\d+", "(>=)", "[a-z_][a-z0-9_]*", "(ab|a)*c?", "a*", "\\d+(x\\d+)?", "(>=|>)", "a*b?"};
+    const std::string inputs[] = {"", "12345678901234567890x", ">=", "abababababababababac", "id_42 = 1", "aaaaaaaaaaaaaaaaaaaaaaa", "\x01"};
+    for (const auto &pattern : patterns) {
+        RegEx sheng(pattern, automatonOptions);
+        RegEx pike(pattern, pikeOptions);
+        EXPECT_EQ(sheng.getEngine(), RegExEngine::SHENG) << pattern;
+        for (const auto &input : inputs) {
+            EXPECT_EQ(sheng.match(input), pike.match(input)) << pattern << " on " << input;
+        }
+    }
+
+    // 状态过多时保持普通 DFA
+    EXPECT_EQ(RegEx("(a|b)*a(a|b)(a|b)(a|b)(a|b)").getEngine(), RegExEngine::DFA);
+}
+
+// 自环状态加速：长串的空白、标识符与逐字节转移结果一致
+TEST_F(RegExTest, SelfLoopAcceleration) {
+    RegExOptions pikeOptions;
+    pikeOptions.mode = RegExMode::PIKE_VM;
+
+    const std::string run = std::string(100, ' ') + "\t\n" + std::string(37, ' ');
+    const std::string identifier = "id_" + std::string(70, 'x') + "42";
+    const std::string inputs[] = {run, run + "x", identifier, identifier + "+", identifier + "\x01" + identifier};
+
+    // 超过 16 个状态的模式走普通 DFA，其余走 Sheng
+    RegExOptions automatonOptions;
+    automatonOptions.specializeSimplePatterns = false;
+
+    const std::string patterns[] = {"\\s+", "[a-z_][a-z0-9_]*", "\\w+|(a|b)*a(a|b)(a|b)(a|b)(a|b)", "\\s+;?"};
+    for (const auto &pattern : patterns) {
+        RegEx regex(pattern, automatonOptions);
+        RegEx pike(pattern, pikeOptions);
+        EXPECT_GT(regex.getStats().acceleratedStateCount, 0) << pattern;
+        for (const auto &input : inputs) {
+            EXPECT_EQ(regex.match(input), pike.match(input)) << pattern;
+        }
+    }
+
+    RegExSet set(std::vector<std::string>{"\\d+", "\\w+", "\\s+"});
+    EXPECT_GT(set.getStats().acceleratedStateCount, 0);
+    EXPECT_EQ(set.match(run)->length, run.size());
+    EXPECT_EQ(set.match(identifier + " ")->length, identifier.size());
+    EXPECT_EQ(set.match(identifier)->patternId, 1);
+}
+
+// 纯字面量与单一字符集闭包不构建自动机
+TEST_F(RegExTest, SpecializedPatterns) {
+    RegExOptions pikeOptions;
+    pikeOptions.mode = RegExMode::PIKE_VM;
+
+    const std::string inputs[] = {"", "!=", "!", "<=x", "12345a", "a", "   \t;", "\x01"};
+    const std::pair<std::string, RegExEngine> patterns[] = {
+        {"(!=)", RegExEngine::LITERAL},
+        {"(<=)", RegExEngine::LITERAL},
+        {"a", RegExEngine::LITERAL},
+        {"\\d+", RegExEngine::CHARSET_RUN},
+        {"\\s*", RegExEngine::CHARSET_RUN},
+        {"[^a-z]+", RegExEngine::CHARSET_RUN},
+        {"a+", RegExEngine::CHARSET_RUN},
+        {"(ab)+", RegExEngine::SHENG},
+    };
+    RegExOptions automatonOptions;
+    automatonOptions.specializeSimplePatterns = false;
+
+    for (const auto &pattern : patterns) {
+        RegEx regex(pattern.first);
+        RegEx pike(pattern.first, pikeOptions);
+        EXPECT_EQ(regex.getEngine(), pattern.second) << pattern.first;
+        if (pattern.second == RegExEngine::LITERAL || pattern.second == RegExEngine::CHARSET_RUN) {
+            EXPECT_EQ(RegEx(pattern.first, automatonOptions).getEngine(), RegExEngine::SHENG) << pattern.first;
+        }
+        for (const auto &input : inputs) {
+            EXPECT_EQ(regex.match(input), pike.match(input)) << pattern.first << " on " << input;
+        }
+    }
+
+    // 保存和统计时才按需构建 DFA，由 literal_ / runBytes_ 重建，与原模式的 DFA 一致
+    const std::string path = ::testing::TempDir() + "cpl_specialized.dfa";
+    for (const std::string pattern : {"if", "\\d+", "[^a-z]*"}) {
+        RegEx regex(pattern);
+        RegEx automaton(pattern, automatonOptions);
+        EXPECT_EQ(regex.getStats().minimizedDfaStateCount, automaton.getStats().minimizedDfaStateCount) << pattern;
+        EXPECT_EQ(regex.getStats().byteClassCount, automaton.getStats().byteClassCount) << pattern;
+        EXPECT_GT(regex.getStats().dfaStateCount, 0) << pattern;
+
+        regex.save(path);
+        RegEx loaded(DFATable::load(path));
+        for (const auto &input : inputs) {
+            EXPECT_EQ(loaded.match(input), regex.match(input)) << pattern << " on " << input;
+        }
+    }
+}
+
+// 语法树化简：单字符或操作合并为字符集，提取公共前缀，折叠嵌套量词
+TEST_F(RegExTest, SimplifyParsedTree) {
+    auto simplify = [](const std::string &pattern) {
+        RegExParser parser(pattern);
+        return RegExSimplifier::simplify(parser.getRoot());
+    };
+
+    auto charSet = std::dynamic_pointer_cast<RegExCharSetNode>(simplify("(a|b|[cd])"));
+    ASSERT_NE(charSet, nullptr);
+    EXPECT_EQ(charSet->getCharSet(), std::set<char>({'a', 'b', 'c', 'd'}));
+
+    // >=|> 变为 >(=)?
+    auto factored = std::dynamic_pointer_cast<RegExConcatenationNode>(simplify("(>=|>)"));
+    ASSERT_NE(factored, nullptr);
+    EXPECT_EQ(std::dynamic_pointer_cast<RegExCharNode>(factored->getLeft())->getCharactar(), '>');
+    EXPECT_NE(std::dynamic_pointer_cast<RegExOptionalNode>(factored->getRight()), nullptr);
+
+    auto star = std::dynamic_pointer_cast<RegExKleeneStarNode>(simplify("(a+)*"));
+    ASSERT_NE(star, nullptr);
+    EXPECT_NE(std::dynamic_pointer_cast<RegExCharNode>(star->getNode()), nullptr);
+
+    // 化简后可以走特化路径，结果不变
+    RegExOptions pikeOptions;
+    pikeOptions.mode = RegExMode::PIKE_VM;
+    EXPECT_EQ(RegEx("(a|b|c)+").getEngine(), RegExEngine::CHARSET_RUN);
+    const std::string patterns[] = {"(a|b|c)+", "(if|int|in)", "(abc|abd|a)", "((a*)*b?)?c", "(a|[^a])+"};
+    const std::string inputs[] = {"", "abcabx", "int", "inx", "abd", "aaac", "c", "\x01"};
+    for (const auto &pattern : patterns) {
+        RegEx regex(pattern);
+        RegEx pike(pattern, pikeOptions);
+        for (const auto &input : inputs) {
+            EXPECT_EQ(regex.match(input), pike.match(input)) << pattern << " on " << input;
+        }
+    }
+}
@@ -0,0 +1,90 @@
+﻿#include "gtest/gtest.h"
+#include "tokenBuffer.h"
+#include <string>
+#include <stdexcept>
+
+class TokenBufferTest : public ::testing::Test {
+protected:
+    // 源码 "a = b;" 的词法结果
+    std::string source = "a = b;";
+
+    void fill(TokenBuffer &tokens) {
+        tokens.setSource(source);
+        tokens.push(_TokenType_::IDENTIFIER, 0, 1);
+        tokens.push(_TokenType_::ASSIGN, 2, 1);
+        tokens.push(_TokenType_::IDENTIFIER, 4, 1);
+        tokens.push(_TokenType_::SEMICOLON, 5, 1);
+        tokens.push(_TokenType_::EOF_TOKEN, 6, 0);
+    }
+};
+
+TEST_F(TokenBufferTest, PushKeepsTypeOffsetAndLength) {
+    TokenBuffer tokens;
+    fill(tokens);
+
+    ASSERT_EQ(tokens.size(), 5);
+    EXPECT_EQ(tokens.getType(1), _TokenType_::ASSIGN);
+    EXPECT_EQ(tokens.getOffset(2), 4u);
+    EXPECT_EQ(tokens.getLength(3), 1u);
+    EXPECT_EQ(tokens.getLexeme(0), "a");
+    EXPECT_EQ(tokens.getLexeme(4), "");
+
+    // clear 只清空 token，源码保持不变
+    tokens.clear();
+    EXPECT_TRUE(tokens.empty());
+    EXPECT_EQ(tokens.getSource(), source);
+}
+
+TEST_F(TokenBufferTest, AppendConcatenatesTokens) {
+    TokenBuffer first;
+    first.setSource(source);
+    first.push(_TokenType_::IDENTIFIER, 0, 1);
+    first.push(_TokenType_::ASSIGN, 2, 1);
+
+    TokenBuffer second;
+    second.setSource(source);
+    second.push(_TokenType_::IDENTIFIER, 4, 1);
+    second.push(_TokenType_::SEMICOLON, 5, 1);
+
+    first.append(second);
+
+    ASSERT_EQ(first.size(), 4);
+    EXPECT_EQ(first.getLexeme(2), "b");
+    EXPECT_EQ(first.getType(3), _TokenType_::SEMICOLON);
+    EXPECT_EQ(second.size(), 2);
+}
+
+TEST_F(TokenBufferTest, SpliceReplacesRangeAndShiftsTail) {
+    TokenBuffer tokens;
+    fill(tokens);
+
+    // "a = b;" -> "a = bcd;"：把 "b" 换成 "bcd"，后面的 token 右移 2 字节
+    source = "a = bcd;";
+    tokens.setSource(source);
+
+    TokenBuffer replacement;
+    replacement.push(_TokenType_::IDENTIFIER, 4, 3);
+    tokens.splice(2, 3, replacement, 2);
+
+    ASSERT_EQ(tokens.size(), 5);
+    EXPECT_EQ(tokens.getLexeme(2), "bcd");
+    EXPECT_EQ(tokens.getOffset(3), 7u);
+    EXPECT_EQ(tokens.getLexeme(3), ";");
+    EXPECT_EQ(tokens.getOffset(4), 8u);
+
+    // 删除 "= bcd"：两个 token 换成零个，负偏移
+    source = "a ;";
+    tokens.setSource(source);
+    tokens.splice(1, 3, TokenBuffer(), -5);
+
+    ASSERT_EQ(tokens.size(), 3);
+    EXPECT_EQ(tokens.getLexeme(0), "a");
+    EXPECT_EQ(tokens.getOffset(1), 2u);
+    EXPECT_EQ(tokens.getLexeme(1), ";");
+    EXPECT_EQ(tokens.getOffset(2), 3u);
+}
+
+TEST_F(TokenBufferTest, RejectsSourceOverMaxSize) {
+    EXPECT_NO_THROW(TokenBuffer::checkSourceSize(TokenBuffer::MAX_SOURCE_SIZE));
+    EXPECT_THROW(TokenBuffer::checkSourceSize(static_cast<size_t>(TokenBuffer::MAX_SOURCE_SIZE) + 1), std::runtime_error);
+}
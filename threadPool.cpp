@@ -0,0 +1,78 @@
+#include "threadPool.h"
+
+thread_local const ThreadPool *ThreadPool::currentPool_ = nullptr;
+
+ThreadPool::ThreadPool(size_t threadCount)
+{
+    stopping_ = false;
+
+    if(threadCount == 0)
+    {
+        threadCount = std::thread::hardware_concurrency();
+    }
+    if(threadCount == 0)
+    {
+        threadCount = 1;
+    }
+
+    workers_.reserve(threadCount);
+    for(size_t i = 0; i < threadCount; i++)
+    {
+        workers_.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    condition_.notify_all();
+
+    for(std::thread &worker : workers_)
+    {
+        worker.join();
+    }
+}
+
+ThreadPool& ThreadPool::getInstance()
+{
+    static ThreadPool instance;
+    return instance;
+}
+
+size_t ThreadPool::getThreadCount() const
+{
+    return workers_.size();
+}
+
+bool ThreadPool::isWorkerThread() const
+{
+    return currentPool_ == this;
+}
+
+void ThreadPool::workerLoop()
+{
+    currentPool_ = this;
+
+    while(true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            condition_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+
+            // queued tasks still run before shutdown
+            if(tasks_.empty())
+            {
+                return;
+            }
+
+            task = std::move(tasks_.front());
+            tasks_.pop();
+        }
+
+        task();
+    }
+}
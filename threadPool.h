@@ -0,0 +1,63 @@
+#ifndef _THREAD_POOL_H_
+#define _THREAD_POOL_H_
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads draining one FIFO task queue.
+// submit() hands back a future, exceptions thrown by a task surface from future::get().
+class ThreadPool
+{
+public:
+    explicit ThreadPool(size_t threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // shared pool sized to the hardware
+    static ThreadPool& getInstance();
+
+    size_t getThreadCount() const;
+    // true on the pool's own workers: a task waiting there for tasks of the same pool can starve it
+    bool isWorkerThread() const;
+
+    template <typename F>
+    std::future<std::invoke_result_t<F>> submit(F &&task)
+    {
+        using Result = std::invoke_result_t<F>;
+
+        auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+        std::future<Result> result = packaged->get_future();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.push([packaged]() { (*packaged)(); });
+        }
+        condition_.notify_one();
+
+        return result;
+    }
+
+private:
+    void workerLoop();
+
+private:
+    // the pool whose worker the calling thread is, if any
+    static thread_local const ThreadPool *currentPool_;
+
+    std::vector<std::thread> workers_;
+    std::queue<std::function<void()>> tasks_;
+
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    bool stopping_;
+};
+
+#endif // _THREAD_POOL_H_
@@ -22,18 +22,49 @@ WorkShop& WorkShop::getInstance()
 
 std::vector<std::string> WorkShop::loadProgram(const std::string &source)
 {
-    Lexer lexer(source);
-    std::vector<Token> tokens;
+    tokenBuffer_.clear();
+    lexer_.setInput(source);
+    lexer_.tokenize(tokenBuffer_);
+
+    return compileTokens();
+}
+
+std::vector<std::string> WorkShop::loadProgramFile(const std::string &path)
+{
+    tokenBuffer_.clear();
+    lexer_.openFile(path);
+    // files can be large, small ones fall back to a sequential pass
+    lexer_.tokenizeParallel(tokenBuffer_);
+
+    return compileTokens();
+}
 
-    while(auto token = lexer.getNextToken())
+std::vector<std::string> WorkShop::editProgram(size_t offset, size_t removedLength, const std::string &insertedText)
+{
+    try
     {
-        std::cout << tokenTypeToString(token->type) << " : " << token->lexeme << std::endl;
-        tokens.push_back(*token);
+        lexer_.relex(tokenBuffer_, offset, removedLength, insertedText);
+    }
+    catch(...)
+    {
+        // the next edit then lexes the whole source again
+        tokenBuffer_.clear();
+        throw;
+    }
+
+    return compileTokens();
+}
 
-        if(token->type == _TokenType_::EOF_TOKEN)
-        {
-            break;
-        }
+std::vector<std::string> WorkShop::compileTokens()
+{
+    // the parser still consumes owning tokens, with positions for its diagnostics
+    const LineIndex &lines = lexer_.getLineIndex();
+    std::vector<Token> tokens;
+    tokens.reserve(tokenBuffer_.size() + 1);
+    for(size_t i = 0; i < tokenBuffer_.size(); i++)
+    {
+        std::cout << tokenTypeToString(tokenBuffer_.getType(i)) << " : " << tokenBuffer_.getLexeme(i) << std::endl;
+        tokens.push_back(tokenBuffer_.getToken(i, lines));
     }
     tokens.push_back(Token{_TokenType_::EOF_TOKEN, ""});
     
@@ -29,11 +29,19 @@ public:
     bool getVMSignFlag() const;
 
     std::vector<std::string> loadProgram(const std::string &source);
+    std::vector<std::string> loadProgramFile(const std::string &path);
+    // re-lexes only around the edit, then compiles the patched token stream
+    std::vector<std::string> editProgram(size_t offset, size_t removedLength, const std::string &insertedText);
 
 private:
+    std::vector<std::string> compileTokens();
 
 private:
     VirtualMachine vm_;
+
+    // source and tokens of the last loaded program, patched in place by editProgram
+    Lexer lexer_;
+    TokenBuffer tokenBuffer_;
 };
 
 #endif // _WORK_SHOP_H_
\ No newline at end of file